@@ -3,5 +3,12 @@
 /// More dartdocs go here.
 library;
 
+export 'src/bulk_options.dart';
+export 'src/cancellation_token.dart';
+export 'src/columnar_result.dart';
 export 'src/mssql_connection.dart';
+export 'src/mssql_pool.dart';
+export 'src/prepared_statement.dart';
+export 'src/result_set.dart';
+export 'src/row_batch.dart';
 export 'src/sql_exception.dart';
\ No newline at end of file
@@ -0,0 +1,435 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'ffi/freetds_bindings.dart';
+import 'ffi/mssql_native_bindings.dart';
+
+/// Column-major source rows for BCP.
+///
+/// Every column is copied once into a single native buffer laid out row after
+/// row (fixed-width values at a constant stride, text and binary values back
+/// to back with a native offset table). Sending a row only points DB-Lib at
+/// that row's slice with `bcp_colptr` (plus `bcp_collen` for variable-length
+/// or nullable columns), so no Dart object or native allocation is made per
+/// row or per cell. With the mssql_native helper, [sendChunk] runs that loop
+/// natively for a whole range of rows in one FFI call.
+///
+/// Accepted column values (all columns must have the same length):
+/// - `Int16List`, `Int32List`, `Int64List`, `Float32List`, `Float64List` and
+///   `Uint8List` (TINYINT) are bound as-is and never NULL;
+/// - `List<int?>`, `List<double?>` and `List<bool?>` are packed into a fixed
+///   width buffer with a NULL flag per row;
+/// - `List<String?>` is sent as NVARCHAR, `List<Uint8List?>` as VARBINARY,
+///   and `List<DateTime?>` as ISO-8601 text (like `bulkInsert`).
+///
+/// Always [dispose] the columns, even after an error.
+class BcpColumns {
+  final List<String> names;
+  final int rowCount;
+  final List<_BcpColumn> _columns;
+  Pointer<MssqlBcpColumn>? _schema;
+
+  BcpColumns._(this.names, this.rowCount, this._columns);
+
+  /// Copy [columns] (column name -> values) into native buffers.
+  ///
+  /// Throws [ArgumentError] when the columns differ in length or a column's
+  /// values are of an unsupported type.
+  factory BcpColumns.fromMap(Map<String, Object> columns) {
+    if (columns.isEmpty) {
+      throw ArgumentError.value(columns, 'columns', 'must not be empty');
+    }
+    final names = columns.keys.toList(growable: false);
+    int? rows;
+    for (final e in columns.entries) {
+      final v = e.value;
+      if (v is! List) {
+        throw ArgumentError.value(v, e.key, 'is not a list of column values');
+      }
+      rows ??= v.length;
+      if (v.length != rows) {
+        throw ArgumentError.value(
+          v.length,
+          e.key,
+          'has a different length than the other columns ($rows)',
+        );
+      }
+    }
+    return BcpColumns._(
+      names,
+      rows!,
+      _build(
+        names.length,
+        (i) => _BcpColumn.from(names[i], columns[names[i]] as List),
+      ),
+    );
+  }
+
+  /// Pack `rows[start, end)` of row maps column by column, encoding column
+  /// `columns[i]` with the host type `hostTypes[i]` (as chosen for
+  /// `bcp_bind`).
+  factory BcpColumns.fromRows(
+    List<Map<String, dynamic>> rows,
+    int start,
+    int end,
+    List<String> columns,
+    List<int> hostTypes,
+  ) => BcpColumns._(
+    columns,
+    end - start,
+    _build(columns.length, (i) {
+      final name = columns[i];
+      final values = List<Object?>.generate(
+        end - start,
+        (r) => rows[start + r][name],
+        growable: false,
+      );
+      return _BcpColumn.pack(hostTypes[i], values);
+    }),
+  );
+
+  /// Pack positional [rows] (values in [columns] order, as in a `RowBatch`)
+  /// with the given host types.
+  factory BcpColumns.fromValues(
+    List<String> columns,
+    List<List<Object?>> rows,
+    List<int> hostTypes,
+  ) => BcpColumns._(
+    columns,
+    rows.length,
+    _build(columns.length, (i) {
+      final values = List<Object?>.generate(
+        rows.length,
+        (r) => rows[r][i],
+        growable: false,
+      );
+      return _BcpColumn.pack(hostTypes[i], values);
+    }),
+  );
+
+  static List<_BcpColumn> _build(int n, _BcpColumn Function(int i) column) {
+    final built = <_BcpColumn>[];
+    try {
+      for (var i = 0; i < n; i++) {
+        built.add(column(i));
+      }
+    } catch (_) {
+      for (final c in built) {
+        c.dispose();
+      }
+      rethrow;
+    }
+    return built;
+  }
+
+  /// The values of [row] keyed by column name, for paths that cannot use BCP.
+  Map<String, dynamic> rowAt(int row) => <String, dynamic>{
+    for (var i = 0; i < names.length; i++) names[i]: _columns[i].valueAt(row),
+  };
+
+  /// `bcp_bind` every column to its buffer; call right after `bcp_init`.
+  void bind(DBLib db, Pointer<DBPROCESS> dbproc) {
+    for (var i = 0; i < _columns.length; i++) {
+      final c = _columns[i];
+      final rc = db.bcp_bind(
+        dbproc,
+        c.data,
+        0,
+        -1,
+        nullptr,
+        0,
+        c.hostType,
+        i + 1,
+      );
+      if (rc != SUCCEED) {
+        throw StateError('bcp_bind failed for column ${i + 1} (${names[i]})');
+      }
+    }
+    prime(db, dbproc);
+  }
+
+  /// Reset the lengths of fixed-width columns, which [setRow] only touches
+  /// around NULLs; call before the first [setRow] of these columns when
+  /// another source sent rows of the same load before.
+  void prime(DBLib db, Pointer<DBPROCESS> dbproc) {
+    for (var i = 0; i < _columns.length; i++) {
+      final width = _columns[i].width;
+      if (width > 0) db.bcp_collen(dbproc, width, i + 1);
+    }
+  }
+
+  /// Point every bound column at the values of [row].
+  void setRow(DBLib db, Pointer<DBPROCESS> dbproc, int row) {
+    for (var i = 0; i < _columns.length; i++) {
+      _columns[i].select(db, dbproc, i + 1, row);
+    }
+  }
+
+  /// Send rows `[first, first + count)` with one `mssql_bcp_send_chunk` call.
+  /// The table's columns must already be bound with these host types.
+  ///
+  /// Returns the rows sent and the index (relative to [first]) of the row
+  /// whose `bcp_sendrow` failed, or -1 when all were sent.
+  (int, int) sendChunk(
+    MssqlNative native,
+    Pointer<DBPROCESS> dbproc,
+    int first,
+    int count,
+  ) {
+    final schema = _schema ??= _nativeSchema();
+    final failed = malloc<Int32>();
+    try {
+      final sent = native.mssql_bcp_send_chunk(
+        dbproc.cast<Void>(),
+        schema,
+        _columns.length,
+        first,
+        count,
+        failed,
+      );
+      return (sent, failed.value);
+    } finally {
+      malloc.free(failed);
+    }
+  }
+
+  Pointer<MssqlBcpColumn> _nativeSchema() {
+    final schema = malloc<MssqlBcpColumn>(_columns.length);
+    for (var i = 0; i < _columns.length; i++) {
+      final c = _columns[i];
+      final s = (schema + i).ref;
+      s.hostType = c.hostType;
+      s.width = c.width;
+      s.data = c.data;
+      s.offsets = c.offsets;
+      s.nulls = c.nulls;
+    }
+    return schema;
+  }
+
+  void dispose() {
+    for (final c in _columns) {
+      c.dispose();
+    }
+    final schema = _schema;
+    if (schema != null) malloc.free(schema);
+    _schema = null;
+  }
+}
+
+class _BcpColumn {
+  final List<Object?> source;
+  final int hostType;
+  final Pointer<Uint8> data;
+
+  /// Bytes per row for fixed-width columns, 0 for variable-length ones.
+  final int width;
+
+  /// Variable-length columns: row `r` spans bytes `[offsets[r],
+  /// offsets[r + 1])` of [data]; `nullptr` for fixed-width columns.
+  final Pointer<Int64> offsets;
+
+  /// Non-zero for NULL rows; `nullptr` when the column has no NULLs.
+  final Pointer<Uint8> nulls;
+
+  _BcpColumn(
+    this.source,
+    this.hostType,
+    this.data,
+    this.width,
+    this.offsets,
+    this.nulls,
+  );
+
+  /// Pick the host type from the list type (or its first non-null value).
+  factory _BcpColumn.from(String name, List values) {
+    if (values is TypedData) {
+      final td = values as TypedData;
+      final int type;
+      if (values is Int16List) {
+        type = SYBINT2;
+      } else if (values is Int32List) {
+        type = SYBINT4;
+      } else if (values is Int64List) {
+        type = SYBINT8;
+      } else if (values is Float32List) {
+        type = SYBREAL;
+      } else if (values is Float64List) {
+        type = SYBFLT8;
+      } else if (values is Uint8List) {
+        type = SYBINT1;
+      } else {
+        throw ArgumentError.value(
+          values.runtimeType,
+          name,
+          'unsupported typed list',
+        );
+      }
+      final bytes = td.lengthInBytes;
+      final p = malloc<Uint8>(bytes == 0 ? 1 : bytes);
+      p
+          .asTypedList(bytes)
+          .setAll(0, td.buffer.asUint8List(td.offsetInBytes, bytes));
+      return _BcpColumn(
+        values,
+        type,
+        p,
+        td.elementSizeInBytes,
+        nullptr,
+        nullptr,
+      );
+    }
+
+    Object? sample;
+    for (final v in values) {
+      if (v != null) {
+        sample = v;
+        break;
+      }
+    }
+    final int type;
+    if (sample is int) {
+      type = values.any((v) => v is int && v != v.toSigned(32))
+          ? SYBINT8
+          : SYBINT4;
+    } else if (sample is double) {
+      type = SYBFLT8;
+    } else if (sample is bool) {
+      type = SYBBIT;
+    } else if (sample is Uint8List) {
+      type = SYBVARBINARY;
+    } else {
+      type = SYBNVARCHAR;
+    }
+    return _BcpColumn.pack(type, values);
+  }
+
+  /// Encode [values] for [hostType]: SYBINT4, SYBINT8, SYBFLT8, SYBBIT,
+  /// SYBVARBINARY, or anything else as UTF-16LE NVARCHAR text.
+  factory _BcpColumn.pack(int hostType, List values) {
+    final n = values.length;
+    var anyNull = false;
+    for (var r = 0; r < n; r++) {
+      if (values[r] == null) {
+        anyNull = true;
+        break;
+      }
+    }
+    Pointer<Uint8> nulls = nullptr;
+    if (anyNull) {
+      nulls = malloc<Uint8>(n);
+      final view = nulls.asTypedList(n);
+      for (var r = 0; r < n; r++) {
+        view[r] = values[r] == null ? 1 : 0;
+      }
+    }
+    try {
+      switch (hostType) {
+        case SYBINT4:
+        case SYBINT8:
+          final width = hostType == SYBINT8 ? 8 : 4;
+          final p = malloc<Uint8>(n == 0 ? 1 : n * width);
+          if (width == 8) {
+            final view = p.cast<Int64>().asTypedList(n);
+            for (var r = 0; r < n; r++) {
+              view[r] = (values[r] as int?) ?? 0;
+            }
+          } else {
+            final view = p.cast<Int32>().asTypedList(n);
+            for (var r = 0; r < n; r++) {
+              view[r] = (values[r] as int?) ?? 0;
+            }
+          }
+          return _BcpColumn(values, hostType, p, width, nullptr, nulls);
+        case SYBFLT8:
+          final p = malloc<Uint8>(n == 0 ? 1 : n * 8);
+          final view = p.cast<Double>().asTypedList(n);
+          for (var r = 0; r < n; r++) {
+            view[r] = (values[r] as num?)?.toDouble() ?? 0;
+          }
+          return _BcpColumn(values, SYBFLT8, p, 8, nullptr, nulls);
+        case SYBBIT:
+          final p = malloc<Uint8>(n == 0 ? 1 : n);
+          final view = p.asTypedList(n);
+          for (var r = 0; r < n; r++) {
+            view[r] = values[r] == true ? 1 : 0;
+          }
+          return _BcpColumn(values, SYBBIT, p, 1, nullptr, nulls);
+        case SYBVARBINARY:
+          final offsets = malloc<Int64>(n + 1);
+          final off = offsets.asTypedList(n + 1);
+          var total = 0;
+          for (var r = 0; r < n; r++) {
+            off[r] = total;
+            total += (values[r] as Uint8List?)?.length ?? 0;
+          }
+          off[n] = total;
+          final p = malloc<Uint8>(total == 0 ? 1 : total);
+          final view = p.asTypedList(total);
+          for (var r = 0; r < n; r++) {
+            final b = values[r] as Uint8List?;
+            if (b != null) view.setAll(off[r], b);
+          }
+          return _BcpColumn(values, SYBVARBINARY, p, 0, offsets, nulls);
+        default:
+          // Text as UTF-16LE, matching the NVARCHAR host type of bulkInsert.
+          final texts = List<String?>.generate(n, (r) {
+            final v = values[r];
+            if (v == null || v is String) return v as String?;
+            return v is DateTime ? v.toIso8601String() : v.toString();
+          }, growable: false);
+          final offsets = malloc<Int64>(n + 1);
+          final off = offsets.asTypedList(n + 1);
+          var total = 0;
+          for (var r = 0; r < n; r++) {
+            off[r] = total;
+            total += (texts[r]?.length ?? 0) * 2;
+          }
+          off[n] = total;
+          final p = malloc<Uint8>(total == 0 ? 1 : total);
+          final view = p.asTypedList(total);
+          for (var r = 0; r < n; r++) {
+            final s = texts[r];
+            if (s == null) continue;
+            var j = off[r];
+            for (var i = 0; i < s.length; i++, j += 2) {
+              final cu = s.codeUnitAt(i);
+              view[j] = cu & 0xFF;
+              view[j + 1] = cu >> 8;
+            }
+          }
+          return _BcpColumn(values, SYBNVARCHAR, p, 0, offsets, nulls);
+      }
+    } catch (_) {
+      if (nulls != nullptr) malloc.free(nulls);
+      rethrow;
+    }
+  }
+
+  Object? valueAt(int row) => source[row];
+
+  void select(DBLib db, Pointer<DBPROCESS> dbproc, int col, int row) {
+    final hasNulls = nulls != nullptr;
+    if (hasNulls && nulls[row] != 0) {
+      db.bcp_collen(dbproc, -1, col);
+      db.bcp_colptr(dbproc, nullptr, col);
+      return;
+    }
+    if (offsets == nullptr) {
+      if (hasNulls) db.bcp_collen(dbproc, width, col);
+      db.bcp_colptr(dbproc, data + row * width, col);
+      return;
+    }
+    final start = offsets[row];
+    db.bcp_collen(dbproc, offsets[row + 1] - start, col);
+    db.bcp_colptr(dbproc, data + start, col);
+  }
+
+  void dispose() {
+    malloc.free(data);
+    if (offsets != nullptr) malloc.free(offsets);
+    if (nulls != nullptr) malloc.free(nulls);
+  }
+}
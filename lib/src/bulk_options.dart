@@ -0,0 +1,119 @@
+/// Server-side controls for a BCP load (`bulkInsert`, `bulkInsertColumns`,
+/// `bulkInsertStream`, `parallelBulkInsert`).
+///
+/// Each flag maps to a bulk-load hint sent with the load (`bcp_options`
+/// with `BCPHINTS`), except [keepIdentity], which is a `bcp_control`
+/// setting. Options are ignored for `#temp` tables, which are not loaded
+/// through BCP.
+class BulkOptions {
+  /// Take a bulk update table lock (`TABLOCK`). Together with the SIMPLE or
+  /// BULK_LOGGED recovery model this allows a minimally logged load into a
+  /// heap, or into an empty clustered index.
+  final bool tableLock;
+
+  /// Columns the rows are already sorted by (`ORDER(...)`), each optionally
+  /// followed by `ASC` or `DESC`, e.g. `['id', 'ts DESC']`. When it matches
+  /// the clustered index the server skips its sort.
+  final List<String> order;
+
+  /// Enforce CHECK and FOREIGN KEY constraints (`CHECK_CONSTRAINTS`); the
+  /// server skips them by default and marks them untrusted.
+  final bool checkConstraints;
+
+  /// Run the table's INSERT triggers (`FIRE_TRIGGERS`).
+  final bool fireTriggers;
+
+  /// Store NULL for NULL values instead of applying column defaults
+  /// (`KEEP_NULLS`).
+  final bool keepNulls;
+
+  /// Insert the supplied identity values instead of generating new ones
+  /// (`bcp_control(BCPKEEPIDENTITY)`).
+  final bool keepIdentity;
+
+  /// Approximate total rows of the load (`ROWS_PER_BATCH`), a sizing hint
+  /// for the server's plan.
+  final int? rowsPerBatch;
+
+  /// Approximate kilobytes per batch (`KILOBYTES_PER_BATCH`).
+  final int? kilobytesPerBatch;
+
+  const BulkOptions({
+    this.tableLock = false,
+    this.order = const <String>[],
+    this.checkConstraints = false,
+    this.fireTriggers = false,
+    this.keepNulls = false,
+    this.keepIdentity = false,
+    this.rowsPerBatch,
+    this.kilobytesPerBatch,
+  });
+
+  /// The hint list sent with the load, e.g. `TABLOCK, ORDER([id] ASC)`;
+  /// empty when no hint is set.
+  String get hints {
+    final parts = <String>[
+      if (tableLock) 'TABLOCK',
+      if (order.isNotEmpty) 'ORDER(${order.map(_orderColumn).join(', ')})',
+      if (checkConstraints) 'CHECK_CONSTRAINTS',
+      if (fireTriggers) 'FIRE_TRIGGERS',
+      if (keepNulls) 'KEEP_NULLS',
+      if (rowsPerBatch != null) 'ROWS_PER_BATCH = $rowsPerBatch',
+      if (kilobytesPerBatch != null) 'KILOBYTES_PER_BATCH = $kilobytesPerBatch',
+    ];
+    return parts.join(', ');
+  }
+
+  /// A copy with the given fields replaced.
+  BulkOptions copyWith({
+    bool? tableLock,
+    List<String>? order,
+    bool? checkConstraints,
+    bool? fireTriggers,
+    bool? keepNulls,
+    bool? keepIdentity,
+    int? rowsPerBatch,
+    int? kilobytesPerBatch,
+  }) => BulkOptions(
+    tableLock: tableLock ?? this.tableLock,
+    order: order ?? this.order,
+    checkConstraints: checkConstraints ?? this.checkConstraints,
+    fireTriggers: fireTriggers ?? this.fireTriggers,
+    keepNulls: keepNulls ?? this.keepNulls,
+    keepIdentity: keepIdentity ?? this.keepIdentity,
+    rowsPerBatch: rowsPerBatch ?? this.rowsPerBatch,
+    kilobytesPerBatch: kilobytesPerBatch ?? this.kilobytesPerBatch,
+  );
+
+  static final RegExp _direction = RegExp(
+    r'\s+(ASC|DESC)$',
+    caseSensitive: false,
+  );
+
+  static String _orderColumn(String spec) {
+    final s = spec.trim();
+    final m = _direction.firstMatch(s);
+    final name = m == null ? s : s.substring(0, m.start);
+    final dir = m == null ? 'ASC' : m.group(1)!.toUpperCase();
+    return '[${name.replaceAll(']', ']]')}] $dir';
+  }
+
+  @override
+  String toString() =>
+      'BulkOptions(${hints.isEmpty ? '-' : hints}'
+      '${keepIdentity ? ', KEEP_IDENTITY' : ''})';
+}
+
+/// Host file layout written by `bulkExport`.
+enum BulkExportFormat {
+  /// SQL Server native format: each value in its server type with BCP's
+  /// length prefixes, as produced by `bcp -n` and read back by
+  /// `BULK INSERT ... WITH (DATAFILETYPE = 'native')` or `bcp in -n`.
+  native,
+
+  /// Delimited text: values converted to text and separated by the field
+  /// and row terminators. This is not CSV: values are neither quoted nor
+  /// escaped, so a value containing a terminator corrupts the file. Choose
+  /// terminators that do not occur in the data (e.g. tab and newline).
+  character,
+}
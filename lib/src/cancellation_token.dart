@@ -0,0 +1,34 @@
+/// Cooperative cancellation signal for a running query or bulk load.
+///
+/// Pass the same token to any number of calls; [cancel] abandons whichever
+/// of them is still running. A call that was cancelled fails with a
+/// `QueryCancelledException` and leaves its session ready for the next
+/// command.
+class CancellationToken {
+  final List<void Function()> _callbacks = <void Function()>[];
+  bool _cancelled = false;
+
+  bool get isCancelled => _cancelled;
+
+  /// Request cancellation. Idempotent.
+  void cancel() {
+    if (_cancelled) return;
+    _cancelled = true;
+    final callbacks = List<void Function()>.of(_callbacks);
+    _callbacks.clear();
+    for (final cb in callbacks) {
+      cb();
+    }
+  }
+
+  /// Run [callback] once when this token is cancelled (right away if it
+  /// already is). Returns a function that unregisters it.
+  void Function() register(void Function() callback) {
+    if (_cancelled) {
+      callback();
+      return () {};
+    }
+    _callbacks.add(callback);
+    return () => _callbacks.remove(callback);
+  }
+}
@@ -0,0 +1,291 @@
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'columnar_result.dart';
+import 'ffi/freetds_bindings.dart';
+import 'row_reader.dart';
+
+/// Accumulates DB-Lib rows straight into per-column typed buffers.
+///
+/// Fixed-width values are read from the current row and written into growable byte
+/// buffers without creating Dart objects per cell; only text that needs
+/// transcoding and types decoded through `dbconvert` allocate.
+class ColumnarBuilder {
+  final List<String> _names;
+  final List<int> _types;
+  final List<ColumnKind> _kinds;
+  final List<_Bytes> _values;
+  final List<_Bytes> _nulls;
+  final List<_Bytes?> _offsets;
+  int _rows = 0;
+
+  ColumnarBuilder._(
+    this._names,
+    this._types,
+    this._kinds,
+    this._values,
+    this._nulls,
+    this._offsets,
+  );
+
+  /// Prepare column buffers for the current result set of [dbproc].
+  factory ColumnarBuilder.forResultSet(DBLib db, Pointer<DBPROCESS> dbproc) {
+    final ncols = db.dbnumcols(dbproc);
+    final names = <String>[];
+    final types = <int>[];
+    final kinds = <ColumnKind>[];
+    final offsets = <_Bytes?>[];
+    for (var i = 1; i <= ncols; i++) {
+      final cptr = db.dbcolname(dbproc, i);
+      final type = db.dbcoltype(dbproc, i);
+      final kind = columnKindFor(type, db.dbcollen(dbproc, i));
+      names.add(cptr == nullptr ? 'col$i' : cptr.toDartString());
+      types.add(type);
+      kinds.add(kind);
+      final varWidth = kind == ColumnKind.string || kind == ColumnKind.binary;
+      offsets.add(varWidth ? (_Bytes()..addInt32(0)) : null);
+    }
+    return ColumnarBuilder._(
+      names,
+      types,
+      kinds,
+      List<_Bytes>.generate(ncols, (_) => _Bytes()),
+      List<_Bytes>.generate(ncols, (_) => _Bytes()),
+      offsets,
+    );
+  }
+
+  /// A builder with no columns, for batches that return no rows.
+  factory ColumnarBuilder.empty() => ColumnarBuilder._(
+    const <String>[],
+    const <int>[],
+    const <ColumnKind>[],
+    const <_Bytes>[],
+    const <_Bytes>[],
+    const <_Bytes?>[],
+  );
+
+  /// Storage kind for a DB-Lib [type] whose maximum width is [collen].
+  static ColumnKind columnKindFor(int type, int collen) {
+    switch (type) {
+      case SYBINT1:
+      case SYBINT2:
+      case SYBINT4:
+        return ColumnKind.int32;
+      case SYBINT8:
+        return ColumnKind.int64;
+      case SYBINTN:
+        return collen > 4 ? ColumnKind.int64 : ColumnKind.int32;
+      case SYBREAL:
+      case SYBFLT8:
+      case SYBFLTN:
+      case SYBMONEY:
+      case SYBMONEY4:
+      case SYBMONEYN:
+      case SYBDECIMAL:
+      case SYBNUMERIC:
+        return ColumnKind.float64;
+      case SYBBIT:
+      case SYBBITN:
+        return ColumnKind.boolean;
+      case SYBBINARY:
+      case SYBVARBINARY:
+      case SYBIMAGE:
+        return ColumnKind.binary;
+      default:
+        return ColumnKind.string;
+    }
+  }
+
+  int get rowCount => _rows;
+
+  /// Append the row [reader] is positioned on.
+  void addRow(DBLib db, Pointer<DBPROCESS> dbproc, RowReader reader) {
+    final row = _rows;
+    for (var c = 0; c < _kinds.length; c++) {
+      final ptr = reader.data(c + 1);
+      final len = reader.length(c + 1);
+      final nulls = _nulls[c];
+      if ((row & 7) == 0) nulls.addByte(0);
+      final kind = _kinds[c];
+      final values = _values[c];
+      final isNull =
+          ptr == nullptr ||
+          (len <= 0 && kind != ColumnKind.string && kind != ColumnKind.binary);
+      if (isNull) {
+        nulls.orLastByte(1 << (row & 7));
+        switch (kind) {
+          case ColumnKind.int32:
+            values.addInt32(0);
+          case ColumnKind.int64:
+            values.addInt64(0);
+          case ColumnKind.float64:
+            values.addFloat64(0);
+          case ColumnKind.boolean:
+            values.addByte(0);
+          case ColumnKind.string:
+          case ColumnKind.binary:
+            _offsets[c]!.addInt32(values.length);
+        }
+        continue;
+      }
+      final type = _types[c];
+      switch (kind) {
+        case ColumnKind.int32:
+          values.addInt32(_readInt(ptr, len));
+        case ColumnKind.int64:
+          values.addInt64(_readInt(ptr, len));
+        case ColumnKind.float64:
+          values.addFloat64(_readDouble(db, dbproc, type, ptr, len));
+        case ColumnKind.boolean:
+          values.addByte(ptr.value != 0 ? 1 : 0);
+        case ColumnKind.binary:
+          values.addBytes(ptr.asTypedList(len));
+          _offsets[c]!.addInt32(values.length);
+        case ColumnKind.string:
+          final text = dbTextAsUtf8(type, ptr, len);
+          if (text != null) {
+            values.addBytes(text);
+          } else {
+            final v = decodeDbValueWithFallback(db, dbproc, type, ptr, len);
+            if (v != null) values.addBytes(utf8.encode('$v'));
+          }
+          _offsets[c]!.addInt32(values.length);
+      }
+    }
+    _rows++;
+  }
+
+  ColumnarResult build(int affected) {
+    final columns = <ColumnarColumn>[];
+    for (var c = 0; c < _kinds.length; c++) {
+      final kind = _kinds[c];
+      final values = _values[c];
+      TypedData? fixed;
+      Int32List? offsets;
+      Uint8List? data;
+      switch (kind) {
+        case ColumnKind.int32:
+          fixed = values.takeBytes().buffer.asInt32List(0, _rows);
+        case ColumnKind.int64:
+          fixed = values.takeBytes().buffer.asInt64List(0, _rows);
+        case ColumnKind.float64:
+          fixed = values.takeBytes().buffer.asFloat64List(0, _rows);
+        case ColumnKind.boolean:
+          fixed = values.takeBytes();
+        case ColumnKind.string:
+        case ColumnKind.binary:
+          data = values.takeBytes();
+          final ends = _offsets[c]!.takeBytes();
+          offsets = ends.buffer.asInt32List(0, _rows + 1);
+      }
+      columns.add(
+        ColumnarColumn(
+          name: _names[c],
+          kind: kind,
+          sqlType: _types[c],
+          length: _rows,
+          nulls: _nulls[c].takeBytes(),
+          values: fixed,
+          offsets: offsets,
+          data: data,
+        ),
+      );
+    }
+    return ColumnarResult(columns, _rows, affected);
+  }
+}
+
+int _readInt(Pointer<Uint8> ptr, int len) {
+  final bd = ByteData.sublistView(ptr.asTypedList(len));
+  switch (len) {
+    case 1:
+      return bd.getUint8(0);
+    case 2:
+      return bd.getInt16(0, Endian.little);
+    case 4:
+      return bd.getInt32(0, Endian.little);
+    default:
+      return bd.getInt64(0, Endian.little);
+  }
+}
+
+double _readDouble(
+  DBLib db,
+  Pointer<DBPROCESS> dbproc,
+  int type,
+  Pointer<Uint8> ptr,
+  int len,
+) {
+  if (type == SYBREAL || type == SYBFLT8 || type == SYBFLTN) {
+    final bd = ByteData.sublistView(ptr.asTypedList(len));
+    return len == 4
+        ? bd.getFloat32(0, Endian.little)
+        : bd.getFloat64(0, Endian.little);
+  }
+  final v = decodeDbValueWithFallback(db, dbproc, type, ptr, len);
+  if (v is num) return v.toDouble();
+  return double.tryParse('$v') ?? double.nan;
+}
+
+/// Growable byte buffer with typed appends in host byte order, so the result
+/// can be viewed directly as an [Int32List]/[Int64List]/[Float64List].
+class _Bytes {
+  Uint8List _buf = Uint8List(256);
+  late ByteData _view = ByteData.view(_buf.buffer);
+  int length = 0;
+
+  void _reserve(int extra) {
+    final need = length + extra;
+    if (need <= _buf.length) return;
+    var cap = _buf.length * 2;
+    while (cap < need) {
+      cap *= 2;
+    }
+    final next = Uint8List(cap)..setRange(0, length, _buf);
+    _buf = next;
+    _view = ByteData.view(next.buffer);
+  }
+
+  void addByte(int v) {
+    _reserve(1);
+    _buf[length++] = v;
+  }
+
+  void orLastByte(int mask) {
+    _buf[length - 1] |= mask;
+  }
+
+  void addInt32(int v) {
+    _reserve(4);
+    _view.setInt32(length, v, Endian.host);
+    length += 4;
+  }
+
+  void addInt64(int v) {
+    _reserve(8);
+    _view.setInt64(length, v, Endian.host);
+    length += 8;
+  }
+
+  void addFloat64(double v) {
+    _reserve(8);
+    _view.setFloat64(length, v, Endian.host);
+    length += 8;
+  }
+
+  void addBytes(List<int> bytes) {
+    _reserve(bytes.length);
+    _buf.setRange(length, length + bytes.length, bytes);
+    length += bytes.length;
+  }
+
+  /// The written bytes, trimmed to [length] (copies only when oversized).
+  Uint8List takeBytes() {
+    if (length == _buf.length) return _buf;
+    return _buf.sublist(0, length);
+  }
+}
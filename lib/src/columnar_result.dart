@@ -0,0 +1,120 @@
+import 'dart:convert';
+import 'dart:typed_data';
+
+/// Storage layout of a [ColumnarColumn].
+enum ColumnKind {
+  /// TINYINT/SMALLINT/INT in an [Int32List].
+  int32,
+
+  /// BIGINT in an [Int64List].
+  int64,
+
+  /// FLOAT/REAL/MONEY/DECIMAL/NUMERIC in a [Float64List].
+  float64,
+
+  /// BIT as 0/1 bytes in a [Uint8List].
+  boolean,
+
+  /// Any other type as UTF-8 text in [ColumnarColumn.data], delimited by
+  /// [ColumnarColumn.offsets] (date/time values use the same ISO-8601 text
+  /// as `getData`).
+  string,
+
+  /// BINARY/VARBINARY/IMAGE as raw bytes, delimited like [string].
+  binary,
+}
+
+/// One column of a [ColumnarResult], stored in typed buffers.
+///
+/// Fixed-width kinds keep one slot per row in [values] (NULL rows hold 0).
+/// [ColumnKind.string] and [ColumnKind.binary] keep row `i` in
+/// `data[offsets[i]..offsets[i + 1]]`. In every kind, bit `i % 8` of
+/// `nulls[i ~/ 8]` is set when row `i` is NULL.
+class ColumnarColumn {
+  final String name;
+  final ColumnKind kind;
+
+  /// DB-Lib type code reported by `dbcoltype`.
+  final int sqlType;
+
+  /// Number of rows.
+  final int length;
+
+  /// NULL bitmap, least significant bit first.
+  final Uint8List nulls;
+
+  /// Row values for fixed-width kinds: [Int32List], [Int64List],
+  /// [Float64List] or [Uint8List]; null for string/binary columns.
+  final TypedData? values;
+
+  /// `length + 1` offsets into [data] for string/binary columns.
+  final Int32List? offsets;
+
+  /// Concatenated row bytes for string/binary columns.
+  final Uint8List? data;
+
+  const ColumnarColumn({
+    required this.name,
+    required this.kind,
+    required this.sqlType,
+    required this.length,
+    required this.nulls,
+    this.values,
+    this.offsets,
+    this.data,
+  });
+
+  bool isNull(int row) => (nulls[row >> 3] & (1 << (row & 7))) != 0;
+
+  Int32List get int32Values => values as Int32List;
+  Int64List get int64Values => values as Int64List;
+  Float64List get float64Values => values as Float64List;
+  Uint8List get boolValues => values as Uint8List;
+
+  /// Raw bytes of row [row] for string/binary columns (a view, no copy).
+  Uint8List bytesAt(int row) =>
+      Uint8List.sublistView(data!, offsets![row], offsets![row + 1]);
+
+  /// Row [row] as a Dart value (allocates; prefer the typed buffers in loops).
+  Object? operator [](int row) {
+    if (isNull(row)) return null;
+    switch (kind) {
+      case ColumnKind.int32:
+        return int32Values[row];
+      case ColumnKind.int64:
+        return int64Values[row];
+      case ColumnKind.float64:
+        return float64Values[row];
+      case ColumnKind.boolean:
+        return boolValues[row] != 0;
+      case ColumnKind.string:
+        return utf8.decode(bytesAt(row), allowMalformed: true);
+      case ColumnKind.binary:
+        return bytesAt(row);
+    }
+  }
+}
+
+/// The first row-bearing result set of a query in column-major form.
+///
+/// See `MssqlConnection.queryColumnar`.
+class ColumnarResult {
+  final List<ColumnarColumn> columns;
+  final int rowCount;
+
+  /// Rows affected across all result sets (as `affected` in `getData`).
+  final int affected;
+
+  const ColumnarResult(this.columns, this.rowCount, this.affected);
+
+  List<String> get columnNames =>
+      List<String>.generate(columns.length, (i) => columns[i].name);
+
+  /// The column called [name], or null.
+  ColumnarColumn? column(String name) {
+    for (final c in columns) {
+      if (c.name == name) return c;
+    }
+    return null;
+  }
+}
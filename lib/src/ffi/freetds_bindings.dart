@@ -18,6 +18,7 @@ import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 
 import '../native_loader.dart';
+import 'mssql_native_bindings.dart';
 
 // Opaque types
 base class DBPROCESS extends Opaque {}
@@ -97,6 +98,12 @@ const int SYBTIME = 51; // (sybase) time
 
 // BCP direction
 const int DB_IN = 1;
+const int DB_OUT = 2; // table -> host file
+const int DB_QUERYOUT = 3; // query -> host file
+// bcp_control field IDs (subset)
+const int BCPKEEPIDENTITY = 8; // insert supplied identity values
+// bcp_options option IDs (subset)
+const int BCPHINTS = 6; // server hints for the load, e.g. "TABLOCK"
 // Login option selector (subset)
 const int DBSETBCP = 6; // enable BCP on LOGINREC
 // dbsetopt option IDs (subset)
@@ -104,12 +111,33 @@ const int DBTEXTSIZE = 17; // set text size for large text retrieval
 // Per sybdb.h, DBSETUSER and DBSETPWD constants used with dbsetlname()
 const int DBSETUSER = 2;
 const int DBSETPWD = 3;
+const int DBSETDBNAME = 14; // initial database, sent in the login packet
+const int DBSETPACKET = 11; // requested TDS packet size (dbsetllong)
 
 // RPC options (per sybdb.h)
 // DBRPCRECOMPILE causes the stored procedure to be recompiled before executing.
 // DBRPCRESET cancels any pending RPC(s) and resets the internal RPC state.
 const int DBRPCRECOMPILE = 0x0001;
 const int DBRPCRESET = 0x0002;
+// dbrpcparam status: the parameter is an OUTPUT parameter
+const int DBRPCRETURN = 0x0001;
+
+// Error/interrupt handler return codes (per sybdb.h)
+const int INT_CONTINUE = 1;
+const int INT_CANCEL = 2;
+const int INT_TIMEOUT = 3;
+// DB-Lib error number reported when a read from the server times out
+const int SYBETIME = 20003;
+
+// dbbind() program variable types (per sybdb.h, subset)
+const int TINYBIND = 6; // DBTINYINT (1 byte)
+const int SMALLBIND = 7; // DBSMALLINT (2 bytes)
+const int INTBIND = 8; // DBINT (4 bytes)
+const int FLT8BIND = 9; // DBFLT8 (8 bytes)
+const int REALBIND = 10; // DBREAL (4 bytes)
+const int DATETIMEBIND = 11; // DBDATETIME (8 bytes)
+const int BITBIND = 16; // DBBIT (1 byte)
+const int BIGINTBIND = 30; // DBBIGINT (8 bytes)
 
 // Typedefs
 //
@@ -176,6 +204,10 @@ typedef _dbcolnameDart = Pointer<Utf8> Function(Pointer<DBPROCESS>, int);
 typedef _dbcoltypeC = Int32 Function(Pointer<DBPROCESS>, Int32);
 typedef _dbcoltypeDart = int Function(Pointer<DBPROCESS>, int);
 
+/// C: DBINT dbcollen(DBPROCESS*, int col) — Maximum byte length of a column
+typedef _dbcollenC = Int32 Function(Pointer<DBPROCESS>, Int32);
+typedef _dbcollenDart = int Function(Pointer<DBPROCESS>, int);
+
 /// C: int dbdatlen(DBPROCESS*, int col) — Byte length of current row’s column value
 typedef _dbdatlenC = Int32 Function(Pointer<DBPROCESS>, Int32);
 typedef _dbdatlenDart = int Function(Pointer<DBPROCESS>, int);
@@ -188,6 +220,24 @@ typedef _dbdataDart = Pointer<Uint8> Function(Pointer<DBPROCESS>, int);
 typedef _dbcountC = Int32 Function(Pointer<DBPROCESS>);
 typedef _dbcountDart = int Function(Pointer<DBPROCESS>);
 
+/// C: RETCODE dbbind(DBPROCESS*, int col, int vartype, DBINT varlen,
+///                   BYTE* varaddr) — Copy column [col] into [varaddr] on
+/// every dbnextrow
+typedef _dbbindC =
+    Int32 Function(Pointer<DBPROCESS>, Int32, Int32, Int32, Pointer<Uint8>);
+typedef _dbbindDart =
+    int Function(Pointer<DBPROCESS>, int, int, int, Pointer<Uint8>);
+
+/// C: RETCODE dbnullbind(DBPROCESS*, int col, DBINT* indicator) — Receive
+/// -1 in [indicator] when the bound column is NULL
+typedef _dbnullbindC = Int32 Function(Pointer<DBPROCESS>, Int32, Pointer<Int32>);
+typedef _dbnullbindDart = int Function(Pointer<DBPROCESS>, int, Pointer<Int32>);
+
+/// C: RETCODE dbcancel(DBPROCESS*) — Cancel the current batch and discard
+/// any pending results
+typedef _dbcancelC = Int32 Function(Pointer<DBPROCESS>);
+typedef _dbcancelDart = int Function(Pointer<DBPROCESS>);
+
 // Group: Timeouts and database selection
 /// C: int dbsetlogintime(int seconds) — Login/connect timeout
 typedef _dbsetlogintimeC = Int32 Function(Int32);
@@ -202,10 +252,18 @@ typedef _dbuseC = Int32 Function(Pointer<DBPROCESS>, Pointer<Utf8>);
 typedef _dbuseDart = int Function(Pointer<DBPROCESS>, Pointer<Utf8>);
 
 // Group: LOGINREC options (e.g., enable BCP using DBSETBCP)
-/// C: int dbsetlbool(LOGINREC*, int option, int value) — Toggle login options
+/// C: int dbsetlbool(LOGINREC*, int value, int which) — Toggle login options
 typedef _dbsetlboolC = Int32 Function(Pointer<LOGINREC>, Int32, Int32);
 typedef _dbsetlboolDart = int Function(Pointer<LOGINREC>, int, int);
 
+/// C: int dbsetllong(LOGINREC*, long value, int which) — Numeric login options
+typedef _dbsetllongC = Int32 Function(Pointer<LOGINREC>, Long, Int32);
+typedef _dbsetllongDart = int Function(Pointer<LOGINREC>, int, int);
+
+/// C: int dbgetpacket(DBPROCESS*) — TDS packet size negotiated at login
+typedef _dbgetpacketC = Int32 Function(Pointer<DBPROCESS>);
+typedef _dbgetpacketDart = int Function(Pointer<DBPROCESS>);
+
 /// C: int dbsetopt(DBPROCESS*, int option, const char* char_param, int int_param)
 typedef _dbsetoptC =
     Int32 Function(Pointer<DBPROCESS>, Int32, Pointer<Utf8>, Int32);
@@ -248,6 +306,20 @@ typedef _dbrpcsendDart = int Function(Pointer<DBPROCESS>);
 typedef _dbsqlokC = Int32 Function(Pointer<DBPROCESS>);
 typedef _dbsqlokDart = int Function(Pointer<DBPROCESS>);
 
+/// C: int dbnumrets(DBPROCESS*) — Number of RPC return (OUTPUT) parameters
+typedef _dbnumretsC = Int32 Function(Pointer<DBPROCESS>);
+typedef _dbnumretsDart = int Function(Pointer<DBPROCESS>);
+
+/// C: BYTE* dbretdata(DBPROCESS*, int retnum) — Value of return parameter
+/// [retnum] (1-based)
+typedef _dbretdataC = Pointer<Uint8> Function(Pointer<DBPROCESS>, Int32);
+typedef _dbretdataDart = Pointer<Uint8> Function(Pointer<DBPROCESS>, int);
+
+/// C: DBINT dbretlen(DBPROCESS*, int retnum) — Byte length of return
+/// parameter [retnum]
+typedef _dbretlenC = Int32 Function(Pointer<DBPROCESS>, Int32);
+typedef _dbretlenDart = int Function(Pointer<DBPROCESS>, int);
+
 // Group: Error and message handlers
 /// C: EHANDLEFUNC dberrhandle(EHANDLEFUNC handler)
 typedef _errHandlerSigC =
@@ -289,6 +361,25 @@ typedef _dbmsghandleDart =
       Pointer<NativeFunction<_msgHandlerSigC>>,
     );
 
+// Group: Interrupts
+/// C: int (*DB_DBCHKINTR_FUNC)(void* dbproc) / int (*DB_DBHNDLINTR_FUNC)(void* dbproc)
+typedef _intrHandlerSigC = Int32 Function(Pointer<Void>);
+
+/// C: void dbsetinterrupt(DBPROCESS*, DB_DBCHKINTR_FUNC chkintr,
+///                        DB_DBHNDLINTR_FUNC hndlintr)
+typedef _dbsetinterruptC =
+    Void Function(
+      Pointer<DBPROCESS>,
+      Pointer<NativeFunction<_intrHandlerSigC>>,
+      Pointer<NativeFunction<_intrHandlerSigC>>,
+    );
+typedef _dbsetinterruptDart =
+    void Function(
+      Pointer<DBPROCESS>,
+      Pointer<NativeFunction<_intrHandlerSigC>>,
+      Pointer<NativeFunction<_intrHandlerSigC>>,
+    );
+
 // Group: BCP (bulk copy) — high-throughput inserts
 /// C: int bcp_init(DBPROCESS*, const char* table, const char* datafile,
 ///                 const char* errorfile, int direction)
@@ -356,6 +447,50 @@ typedef _bcp_colptrC =
     Int32 Function(Pointer<DBPROCESS>, Pointer<Uint8>, Int32);
 typedef _bcp_colptrDart = int Function(Pointer<DBPROCESS>, Pointer<Uint8>, int);
 
+/// C: int bcp_columns(DBPROCESS*, int host_colcount) — Number of host file columns (after bcp_init with a file)
+typedef _bcp_columnsC = Int32 Function(Pointer<DBPROCESS>, Int32);
+typedef _bcp_columnsDart = int Function(Pointer<DBPROCESS>, int);
+
+/// C: int bcp_colfmt(DBPROCESS*, int host_column, int host_type,
+///                   int host_prefixlen, DBINT host_collen,
+///                   const BYTE* host_term, int host_termlen, int table_colnum)
+typedef _bcp_colfmtC =
+    Int32 Function(
+      Pointer<DBPROCESS>,
+      Int32 /*host_column*/,
+      Int32 /*host_type*/,
+      Int32 /*host_prefixlen*/,
+      Int32 /*host_collen*/,
+      Pointer<Uint8> /*host_term*/,
+      Int32 /*host_termlen*/,
+      Int32 /*table_colnum*/,
+    );
+typedef _bcp_colfmtDart =
+    int Function(
+      Pointer<DBPROCESS>,
+      int,
+      int,
+      int,
+      int,
+      Pointer<Uint8>,
+      int,
+      int,
+    );
+
+/// C: int bcp_exec(DBPROCESS*, DBINT* rows_copied) — Run a file copy
+typedef _bcp_execC = Int32 Function(Pointer<DBPROCESS>, Pointer<Int32>);
+typedef _bcp_execDart = int Function(Pointer<DBPROCESS>, Pointer<Int32>);
+
+/// C: int bcp_control(DBPROCESS*, int field, DBINT value) — Set a load control (after bcp_init)
+typedef _bcp_controlC = Int32 Function(Pointer<DBPROCESS>, Int32, Int32);
+typedef _bcp_controlDart = int Function(Pointer<DBPROCESS>, int, int);
+
+/// C: int bcp_options(DBPROCESS*, int option, BYTE* value, int valuelen) — Set a load option (after bcp_init)
+typedef _bcp_optionsC =
+    Int32 Function(Pointer<DBPROCESS>, Int32, Pointer<Uint8>, Int32);
+typedef _bcp_optionsDart =
+    int Function(Pointer<DBPROCESS>, int, Pointer<Uint8>, int);
+
 // Group: Type conversion helper
 /// C: int dbconvert(DBPROCESS*, int srctype, BYTE* src, int srclen,
 ///                  int desttype, BYTE* dest, int destlen)
@@ -415,165 +550,172 @@ class DBLib {
   - For high-throughput inserts, use BCP APIs (bcp_init/bind/sendrow/batch/done).
   */
   final DynamicLibrary _lib;
-  late final _dbinitDart dbinit;
-  late final _dbloginDart dblogin;
-  late final _dbsetlnameDart dbsetlname;
-  late final _dbopenDart dbopen;
-  late final _dbcloseDart dbclose;
-  late final _dbexitDart dbexit;
-
-  late final _dbcmdDart dbcmd;
-  late final _dbsqlexecDart dbsqlexec;
-  late final _dbresultsDart dbresults;
-  late final _dbnextrowDart dbnextrow;
-  late final _dbnumcolsDart dbnumcols;
-  late final _dbcolnameDart dbcolname;
-  late final _dbcoltypeDart dbcoltype;
-  late final _dbdatlenDart dbdatlen;
-  late final _dbdataDart dbdata;
-  late final _dbcountDart dbcount;
-
-  late final _dbsetlogintimeDart dbsetlogintime;
-  late final _dbsettimeDart dbsettime;
-  late final _dbuseDart dbuse;
-  late final _dbsetlboolDart dbsetlbool;
-  late final _dbsetoptDart dbsetopt;
-
-  late final _dbrpcinitDart dbrpcinit;
-  late final _dbrpcparamDart dbrpcparam;
-  late final _dbrpcsendDart dbrpcsend;
-  late final _dbsqlokDart dbsqlok;
-  late final _dberrhandleDart dberrhandle;
-  late final _dbmsghandleDart dbmsghandle;
-
-  late final _bcp_initDart bcp_init;
-  late final _bcp_bindDart bcp_bind;
-  late final _bcp_sendrowDart bcp_sendrow;
-  late final _bcp_batchDart bcp_batch;
-  late final _bcp_doneDart bcp_done;
-  late final _bcp_collenDart bcp_collen;
-  late final _bcp_colptrDart bcp_colptr;
-  late final _dbconvertDart dbconvert;
-
-  DBLib(this._lib) {
-    // Lookups: Connection lifecycle (init/login/open/close)
-    dbinit = _lib.lookupFunction<_dbinitC, _dbinitDart>(
-      'dbinit',
-    ); // Initialize DB-Lib
-    dblogin = _lib.lookupFunction<_dbloginC, _dbloginDart>(
-      'dblogin',
-    ); // Create LOGINREC
-    // DBSETLUSER/DBSETLPWD are macros -> bind the underlying function dbsetlname
-    dbsetlname = _lib.lookupFunction<_dbsetlnameC, _dbsetlnameDart>(
-      'dbsetlname',
-    ); // Set LOGINREC field by selector
-    dbopen = _lib.lookupFunction<_dbopenC, _dbopenDart>(
-      'dbopen',
-    ); // Open DBPROCESS connection
-    dbclose = _lib.lookupFunction<_dbcloseC, _dbcloseDart>(
-      'dbclose',
-    ); // Close DBPROCESS
-    dbexit = _lib.lookupFunction<_dbexitC, _dbexitDart>(
-      'dbexit',
-    ); // Shutdown DB-Lib
-
-    // Lookups: Command execution and results iteration (DML/DDL + rows)
-    dbcmd = _lib.lookupFunction<_dbcmdC, _dbcmdDart>('dbcmd'); // Queue SQL text
-    dbsqlexec = _lib.lookupFunction<_dbsqlexecC, _dbsqlexecDart>(
-      'dbsqlexec',
-    ); // Execute queued SQL
-    dbresults = _lib.lookupFunction<_dbresultsC, _dbresultsDart>(
-      'dbresults',
-    ); // Iterate result sets
-    dbnextrow = _lib.lookupFunction<_dbnextrowC, _dbnextrowDart>(
-      'dbnextrow',
-    ); // Fetch next row
-    dbnumcols = _lib.lookupFunction<_dbnumcolsC, _dbnumcolsDart>(
-      'dbnumcols',
-    ); // Column count
-    dbcolname = _lib.lookupFunction<_dbcolnameC, _dbcolnameDart>(
-      'dbcolname',
-    ); // Column name
-    dbcoltype = _lib.lookupFunction<_dbcoltypeC, _dbcoltypeDart>(
-      'dbcoltype',
-    ); // Column type code
-    dbdatlen = _lib.lookupFunction<_dbdatlenC, _dbdatlenDart>(
-      'dbdatlen',
-    ); // Current value byte length
-    dbdata = _lib.lookupFunction<_dbdataC, _dbdataDart>(
-      'dbdata',
-    ); // Current value pointer
-    dbcount = _lib.lookupFunction<_dbcountC, _dbcountDart>(
-      'dbcount',
-    ); // Rows affected
-
-    // Lookups: Timeouts and database selection
-    dbsetlogintime = _lib.lookupFunction<_dbsetlogintimeC, _dbsetlogintimeDart>(
-      'dbsetlogintime',
-    ); // Login timeout
-    dbsettime = _lib.lookupFunction<_dbsettimeC, _dbsettimeDart>(
-      'dbsettime',
-    ); // Statement timeout
-    dbuse = _lib.lookupFunction<_dbuseC, _dbuseDart>(
-      'dbuse',
-    ); // Change database
-    dbsetlbool = _lib.lookupFunction<_dbsetlboolC, _dbsetlboolDart>(
-      'dbsetlbool',
-    ); // Toggle login options (e.g., BCP)
-    dbsetopt = _lib.lookupFunction<_dbsetoptC, _dbsetoptDart>(
-      'dbsetopt',
-    ); // Set session options (e.g., DBTEXTSIZE)
-
-    // Lookups: RPC for parameterized queries
-    dbrpcinit = _lib.lookupFunction<_dbrpcinitC, _dbrpcinitDart>(
-      'dbrpcinit',
-    ); // Start RPC (e.g., sp_executesql)
-    dbrpcparam = _lib.lookupFunction<_dbrpcparamC, _dbrpcparamDart>(
-      'dbrpcparam',
-    ); // Add RPC parameter
-    dbrpcsend = _lib.lookupFunction<_dbrpcsendC, _dbrpcsendDart>(
-      'dbrpcsend',
-    ); // Send RPC
-    dbsqlok = _lib.lookupFunction<_dbsqlokC, _dbsqlokDart>(
-      'dbsqlok',
-    ); // Finalize send
-
-    // Lookups: error and message handlers
-    dberrhandle = _lib.lookupFunction<_dberrhandleC, _dberrhandleDart>(
-      'dberrhandle',
-    );
-    dbmsghandle = _lib.lookupFunction<_dbmsghandleC, _dbmsghandleDart>(
-      'dbmsghandle',
-    );
 
-    // Lookups: BCP (bulk copy) high-throughput inserts
-    bcp_init = _lib.lookupFunction<_bcp_initC, _bcp_initDart>(
-      'bcp_init',
-    ); // Init bulk copy
-    bcp_bind = _lib.lookupFunction<_bcp_bindC, _bcp_bindDart>(
-      'bcp_bind',
-    ); // Bind program variables
-    bcp_sendrow = _lib.lookupFunction<_bcp_sendrowC, _bcp_sendrowDart>(
-      'bcp_sendrow',
-    ); // Send row
-    bcp_batch = _lib.lookupFunction<_bcp_batchC, _bcp_batchDart>(
-      'bcp_batch',
-    ); // Commit batch
-    bcp_done = _lib.lookupFunction<_bcp_doneC, _bcp_doneDart>(
-      'bcp_done',
-    ); // Finalize bulk copy
-    bcp_collen = _lib.lookupFunction<_bcp_collenC, _bcp_collenDart>(
-      'bcp_collen',
-    ); // Set column length
-    bcp_colptr = _lib.lookupFunction<_bcp_colptrC, _bcp_colptrDart>(
-      'bcp_colptr',
-    ); // Set column pointer
-
-    // Lookup: Type conversion helper
-    dbconvert = _lib.lookupFunction<_dbconvertC, _dbconvertDart>(
-      'dbconvert',
-    ); // Convert values (fallback)
-  }
+  // Symbols are looked up on first use, so a binding costs one lookup per
+  // function this isolate actually calls.
+
+  // Initialize DB-Lib
+  late final _dbinitDart dbinit = _lib.lookupFunction<_dbinitC, _dbinitDart>(
+    'dbinit',
+  );
+  // Create LOGINREC
+  late final _dbloginDart dblogin = _lib
+      .lookupFunction<_dbloginC, _dbloginDart>('dblogin');
+  // Set LOGINREC field by selector
+  late final _dbsetlnameDart dbsetlname = _lib
+      .lookupFunction<_dbsetlnameC, _dbsetlnameDart>('dbsetlname');
+  // Open DBPROCESS connection
+  late final _dbopenDart dbopen = _lib.lookupFunction<_dbopenC, _dbopenDart>(
+    'dbopen',
+  );
+  // Close DBPROCESS
+  late final _dbcloseDart dbclose = _lib
+      .lookupFunction<_dbcloseC, _dbcloseDart>('dbclose');
+  // Shutdown DB-Lib
+  late final _dbexitDart dbexit = _lib.lookupFunction<_dbexitC, _dbexitDart>(
+    'dbexit',
+  );
+
+  // Queue SQL text
+  late final _dbcmdDart dbcmd = _lib.lookupFunction<_dbcmdC, _dbcmdDart>(
+    'dbcmd',
+  );
+  // Execute queued SQL
+  late final _dbsqlexecDart dbsqlexec = _lib
+      .lookupFunction<_dbsqlexecC, _dbsqlexecDart>('dbsqlexec');
+  // Iterate result sets
+  late final _dbresultsDart dbresults = _lib
+      .lookupFunction<_dbresultsC, _dbresultsDart>('dbresults');
+  // Fetch next row
+  late final _dbnextrowDart dbnextrow = _lib
+      .lookupFunction<_dbnextrowC, _dbnextrowDart>('dbnextrow');
+  // Column count
+  late final _dbnumcolsDart dbnumcols = _lib
+      .lookupFunction<_dbnumcolsC, _dbnumcolsDart>('dbnumcols');
+  // Column name
+  late final _dbcolnameDart dbcolname = _lib
+      .lookupFunction<_dbcolnameC, _dbcolnameDart>('dbcolname');
+  // Column type code
+  late final _dbcoltypeDart dbcoltype = _lib
+      .lookupFunction<_dbcoltypeC, _dbcoltypeDart>('dbcoltype');
+  // Column max length
+  late final _dbcollenDart dbcollen = _lib
+      .lookupFunction<_dbcollenC, _dbcollenDart>('dbcollen');
+  // Current value byte length
+  late final _dbdatlenDart dbdatlen = _lib
+      .lookupFunction<_dbdatlenC, _dbdatlenDart>('dbdatlen');
+  // Current value pointer
+  late final _dbdataDart dbdata = _lib.lookupFunction<_dbdataC, _dbdataDart>(
+    'dbdata',
+  );
+  // Rows affected
+  late final _dbcountDart dbcount = _lib
+      .lookupFunction<_dbcountC, _dbcountDart>('dbcount');
+  // Discard pending results
+  late final _dbcancelDart dbcancel = _lib
+      .lookupFunction<_dbcancelC, _dbcancelDart>('dbcancel');
+  // Bind column to program variable
+  late final _dbbindDart dbbind = _lib.lookupFunction<_dbbindC, _dbbindDart>(
+    'dbbind',
+  );
+  // Bind NULL indicator
+  late final _dbnullbindDart dbnullbind = _lib
+      .lookupFunction<_dbnullbindC, _dbnullbindDart>('dbnullbind');
+
+  // Login timeout
+  late final _dbsetlogintimeDart dbsetlogintime = _lib
+      .lookupFunction<_dbsetlogintimeC, _dbsetlogintimeDart>('dbsetlogintime');
+  // Statement timeout
+  late final _dbsettimeDart dbsettime = _lib
+      .lookupFunction<_dbsettimeC, _dbsettimeDart>('dbsettime');
+  // Change database
+  late final _dbuseDart dbuse = _lib.lookupFunction<_dbuseC, _dbuseDart>(
+    'dbuse',
+  );
+  // Toggle login options (e.g., BCP)
+  late final _dbsetlboolDart dbsetlbool = _lib
+      .lookupFunction<_dbsetlboolC, _dbsetlboolDart>('dbsetlbool');
+  // Numeric login options (e.g., DBSETPACKET)
+  late final _dbsetllongDart dbsetllong = _lib
+      .lookupFunction<_dbsetllongC, _dbsetllongDart>('dbsetllong');
+  // Negotiated packet size
+  late final _dbgetpacketDart dbgetpacket = _lib
+      .lookupFunction<_dbgetpacketC, _dbgetpacketDart>('dbgetpacket');
+  // Set session options (e.g., DBTEXTSIZE)
+  late final _dbsetoptDart dbsetopt = _lib
+      .lookupFunction<_dbsetoptC, _dbsetoptDart>('dbsetopt');
+
+  // Start RPC (e.g., sp_executesql)
+  late final _dbrpcinitDart dbrpcinit = _lib
+      .lookupFunction<_dbrpcinitC, _dbrpcinitDart>('dbrpcinit');
+  // Add RPC parameter
+  late final _dbrpcparamDart dbrpcparam = _lib
+      .lookupFunction<_dbrpcparamC, _dbrpcparamDart>('dbrpcparam');
+  // Send RPC
+  late final _dbrpcsendDart dbrpcsend = _lib
+      .lookupFunction<_dbrpcsendC, _dbrpcsendDart>('dbrpcsend');
+  // Finalize send
+  late final _dbsqlokDart dbsqlok = _lib
+      .lookupFunction<_dbsqlokC, _dbsqlokDart>('dbsqlok');
+  // Count OUTPUT parameters
+  late final _dbnumretsDart dbnumrets = _lib
+      .lookupFunction<_dbnumretsC, _dbnumretsDart>('dbnumrets');
+  // OUTPUT parameter value
+  late final _dbretdataDart dbretdata = _lib
+      .lookupFunction<_dbretdataC, _dbretdataDart>('dbretdata');
+  // OUTPUT parameter length
+  late final _dbretlenDart dbretlen = _lib
+      .lookupFunction<_dbretlenC, _dbretlenDart>('dbretlen');
+  // Error/message handler registration
+  late final _dberrhandleDart dberrhandle = _lib
+      .lookupFunction<_dberrhandleC, _dberrhandleDart>('dberrhandle');
+  late final _dbmsghandleDart dbmsghandle = _lib
+      .lookupFunction<_dbmsghandleC, _dbmsghandleDart>('dbmsghandle');
+  // Poll for cancellation while waiting on the server
+  late final _dbsetinterruptDart dbsetinterrupt = _lib
+      .lookupFunction<_dbsetinterruptC, _dbsetinterruptDart>('dbsetinterrupt');
+
+  // Init bulk copy
+  late final _bcp_initDart bcp_init = _lib
+      .lookupFunction<_bcp_initC, _bcp_initDart>('bcp_init');
+  // Bind program variables
+  late final _bcp_bindDart bcp_bind = _lib
+      .lookupFunction<_bcp_bindC, _bcp_bindDart>('bcp_bind');
+  // Send row
+  late final _bcp_sendrowDart bcp_sendrow = _lib
+      .lookupFunction<_bcp_sendrowC, _bcp_sendrowDart>('bcp_sendrow');
+  // Commit batch
+  late final _bcp_batchDart bcp_batch = _lib
+      .lookupFunction<_bcp_batchC, _bcp_batchDart>('bcp_batch');
+  // Finalize bulk copy
+  late final _bcp_doneDart bcp_done = _lib
+      .lookupFunction<_bcp_doneC, _bcp_doneDart>('bcp_done');
+  // Set column length
+  late final _bcp_collenDart bcp_collen = _lib
+      .lookupFunction<_bcp_collenC, _bcp_collenDart>('bcp_collen');
+  // Set column pointer
+  late final _bcp_colptrDart bcp_colptr = _lib
+      .lookupFunction<_bcp_colptrC, _bcp_colptrDart>('bcp_colptr');
+  // Set host file column count
+  late final _bcp_columnsDart bcp_columns = _lib
+      .lookupFunction<_bcp_columnsC, _bcp_columnsDart>('bcp_columns');
+  // Describe a host file column
+  late final _bcp_colfmtDart bcp_colfmt = _lib
+      .lookupFunction<_bcp_colfmtC, _bcp_colfmtDart>('bcp_colfmt');
+  // Copy between table and host file
+  late final _bcp_execDart bcp_exec = _lib
+      .lookupFunction<_bcp_execC, _bcp_execDart>('bcp_exec');
+  // Set load control (identity)
+  late final _bcp_controlDart bcp_control = _lib
+      .lookupFunction<_bcp_controlC, _bcp_controlDart>('bcp_control');
+  // Set load option (hints)
+  late final _bcp_optionsDart bcp_options = _lib
+      .lookupFunction<_bcp_optionsC, _bcp_optionsDart>('bcp_options');
+  // Convert values (fallback)
+  late final _dbconvertDart dbconvert = _lib
+      .lookupFunction<_dbconvertC, _dbconvertDart>('dbconvert');
+
+  DBLib(this._lib);
 
   /// Set the username on a LOGINREC using the DBSETUSER selector.
   ///
@@ -605,12 +747,91 @@ class DBLib {
 
   static DBLib load() => DBLib(NativeLoader.loadDBLib());
 
+  static DBLib? _instance;
+  static bool _initialized = false;
+
+  /// This isolate's binding, created on first use. The library is opened
+  /// through [NativeLoader.loadDBLib], which remembers where it found it.
+  static DBLib get instance => _instance ??= load();
+
+  /// Whether dbinit has run in this process (as far as this isolate knows).
+  static bool get initialized => _initialized;
+
+  /// Run dbinit once. DB-Lib's context is process-wide, so isolates spawned
+  /// after it ran skip it via [adopt].
+  static DBLib ensureInitialized() {
+    final db = instance;
+    if (!_initialized) {
+      db.dbinit();
+      _initialized = true;
+    }
+    return db;
+  }
+
+  /// Take over library state resolved by the isolate that spawned this one:
+  /// the DB-Lib [path] to open directly and whether dbinit already ran.
+  static void adopt({String? path, bool initialized = false}) {
+    NativeLoader.rememberDBLibPath(path);
+    _initialized = _initialized || initialized;
+  }
+
+  /// Install DB-Lib error/message handlers.
+  ///
+  /// DB-Lib keeps a single process-wide handler pair, but a Dart FFI callback
+  /// may only run on the isolate that created it. When the mssql_native helper
+  /// is available its thread-safe native handlers are installed once for the
+  /// whole process and true is returned. Otherwise this isolate's Dart
+  /// callbacks are installed and false is returned; in that case call this
+  /// again before each DB-Lib call sequence if other isolates use DB-Lib too.
+  bool installHandlers() {
+    final native = MssqlNative.instance;
+    if (native != null) {
+      native.mssql_install_handlers();
+      return true;
+    }
+    dberrhandle(kErrHandlerPtr);
+    dbmsghandle(kMsgHandlerPtr);
+    return false;
+  }
+
+  /// Arm [slot] as the interrupt for [dbproc], or disarm it with null.
+  ///
+  /// While armed, DB-Lib polls the slot about once a second whenever it waits
+  /// on the server and sends an attention once [interruptRequested] holds;
+  /// the blocked call then fails and the session must be flushed with
+  /// [dbcancel]. Uses the mssql_native handlers when available, otherwise
+  /// this isolate's Dart callbacks (valid because the callbacks run on the
+  /// thread that is inside the DB-Lib call).
+  void armInterrupt(Pointer<DBPROCESS> dbproc, Pointer<MssqlInterrupt>? slot) {
+    final native = MssqlNative.instance;
+    if (native != null) {
+      native.mssql_arm_interrupt(dbproc.cast(), slot ?? nullptr);
+      return;
+    }
+    if (slot == null) {
+      _dartInterrupts.remove(dbproc.address);
+      dbsetinterrupt(dbproc, nullptr, nullptr);
+    } else {
+      _dartInterrupts[dbproc.address] = slot;
+      dbsetinterrupt(dbproc, kChkIntrPtr, kHndlIntrPtr);
+    }
+  }
+
+  /// Whether [installHandlers] uses the process-wide native handlers, i.e.
+  /// whether several isolates may run DB-Lib calls concurrently.
+  static bool get hasNativeHandlers => MssqlNative.instance != null;
+
   // Expose latest DB-Lib error/message captured by installed handlers.
   // These are per-DBPROCESS (or 0 for library-level) and are cleared on read.
   static String? takeLastError(Pointer<DBPROCESS>? dbproc) =>
+      MssqlNative.instance?.takeLastError(_storeKey(dbproc)) ??
       _DbLibErrorStore.takeLastError(dbproc);
   static String? takeLastMessage(Pointer<DBPROCESS>? dbproc) =>
+      MssqlNative.instance?.takeLastMessage(_storeKey(dbproc)) ??
       _DbLibErrorStore.takeLastMessage(dbproc);
+
+  static int _storeKey(Pointer<DBPROCESS>? dbproc) =>
+      dbproc == null || dbproc == nullptr ? 0 : dbproc.address;
 }
 
 // Simple global store for the latest error/message per DBPROCESS.
@@ -673,6 +894,8 @@ int _dartDbErrHandler(
       '${safeFromUtf8(dberrstr)}'
       '${oserrstr == nullptr ? '' : ' | ${safeFromUtf8(oserrstr)}'}';
   _DbLibErrorStore.setLastError(dbproc, msg);
+  // Cancel only the statement on a timeout (INT_CANCEL would drop the socket).
+  if (dberr == SYBETIME) return INT_TIMEOUT;
   return 0; // per DB-Lib docs, return value ignored
 }
 
@@ -712,11 +935,31 @@ int _dartDbMsgHandler(
   return 0;
 }
 
+// Interrupt slots armed on this isolate (fallback without mssql_native).
+final Map<int, Pointer<MssqlInterrupt>> _dartInterrupts =
+    <int, Pointer<MssqlInterrupt>>{};
+
+int _dartChkIntr(Pointer<Void> dbproc) {
+  final slot = _dartInterrupts[dbproc.address];
+  // After the attention has gone out, keep waiting for its acknowledgement.
+  if (slot == null || slot.ref.fired != 0) return 0;
+  return interruptRequested(slot) ? 1 : 0;
+}
+
+int _dartHndlIntr(Pointer<Void> dbproc) {
+  _dartInterrupts[dbproc.address]?.ref.fired = 1;
+  return INT_CANCEL;
+}
+
 // Exposed pointers for installation; keep them alive for the process lifetime.
 final Pointer<NativeFunction<_errHandlerSigC>> kErrHandlerPtr =
     Pointer.fromFunction<_errHandlerSigC>(_dartDbErrHandler, 0);
 final Pointer<NativeFunction<_msgHandlerSigC>> kMsgHandlerPtr =
     Pointer.fromFunction<_msgHandlerSigC>(_dartDbMsgHandler, 0);
+final Pointer<NativeFunction<_intrHandlerSigC>> kChkIntrPtr =
+    Pointer.fromFunction<_intrHandlerSigC>(_dartChkIntr, 0);
+final Pointer<NativeFunction<_intrHandlerSigC>> kHndlIntrPtr =
+    Pointer.fromFunction<_intrHandlerSigC>(_dartHndlIntr, INT_CONTINUE);
 
 // Helpers to marshal bytes for dbdata()
 
@@ -849,6 +1092,27 @@ dynamic decodeDbValue(int type, Pointer<Uint8> ptr, int len) {
   }
 }
 
+/// UTF-8 bytes of a text value (CHAR/VARCHAR/TEXT/NCHAR/NVARCHAR/NTEXT), or
+/// null when [type] is not a text type.
+///
+/// Single-byte text that is already UTF-8 is returned as a view over [ptr]
+/// (valid only until the next `dbnextrow`); UTF-16LE text is transcoded.
+Uint8List? dbTextAsUtf8(int type, Pointer<Uint8> ptr, int len) {
+  switch (type) {
+    case SYBCHAR:
+    case SYBVARCHAR:
+    case SYBTEXT:
+      final bytes = ptr.asTypedList(len);
+      if (!_looksUtf16LeText(bytes)) return bytes;
+      return utf8.encode(_utf16leDecode(bytes));
+    case SYBNTEXT:
+    case SYBNVARCHAR:
+      return utf8.encode(_utf16leDecode(ptr.asTypedList(len)));
+    default:
+      return null;
+  }
+}
+
 /// Decode with dbconvert fallback: for any unhandled type, try to stringify to SYBVARCHAR.
 ///
 /// Strategy:
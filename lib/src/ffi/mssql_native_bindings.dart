@@ -0,0 +1,246 @@
+// Bindings for the optional mssql_native helper library (see native/).
+//
+// The helper hosts code that cannot run as Dart FFI callbacks, e.g. DB-Lib's
+// process-wide error/message handlers, which fire on whichever worker isolate
+// is inside a DB-Lib call. When the library is not shipped for a platform,
+// [MssqlNative.instance] is null and callers fall back to pure-Dart paths.
+
+// ignore_for_file: non_constant_identifier_names
+
+import 'dart:convert';
+import 'dart:ffi';
+
+import 'package:ffi/ffi.dart';
+
+import '../native_loader.dart';
+import '../native_logger.dart';
+
+/// ABI version this Dart code was written against (MSSQL_NATIVE_ABI_VERSION).
+const int kMssqlNativeAbiVersion = 4;
+
+/// C: int32_t mssql_native_abi_version(void)
+typedef _abiVersionC = Int32 Function();
+typedef _abiVersionDart = int Function();
+
+/// C: void mssql_install_handlers(void)
+typedef _installHandlersC = Void Function();
+typedef _installHandlersDart = void Function();
+
+/// C: int32_t mssql_take_last_error(void* dbproc, char* buf, int32_t cap)
+/// C: int32_t mssql_take_last_message(void* dbproc, char* buf, int32_t cap)
+typedef _takeTextC = Int32 Function(Pointer<Void>, Pointer<Uint8>, Int32);
+typedef _takeTextDart = int Function(Pointer<Void>, Pointer<Uint8>, int);
+
+/// C: struct mssql_arena — packed rows written by mssql_fetch_rows.
+///
+/// Per cell: int32 length in host order (-1 for NULL) followed by that many
+/// raw bytes, row-major, unpadded.
+final class MssqlArena extends Struct {
+  external Pointer<Uint8> data;
+
+  @Int64()
+  external int size;
+
+  @Int64()
+  external int capacity;
+
+  @Int32()
+  external int rows;
+
+  @Int32()
+  external int status;
+}
+
+/// C: mssql_arena* mssql_arena_new(int64_t initial_capacity)
+typedef _arenaNewC = Pointer<MssqlArena> Function(Int64);
+typedef _arenaNewDart = Pointer<MssqlArena> Function(int);
+
+/// C: void mssql_arena_free(mssql_arena*)
+typedef _arenaFreeC = Void Function(Pointer<MssqlArena>);
+typedef _arenaFreeDart = void Function(Pointer<MssqlArena>);
+
+/// C: int32_t mssql_fetch_rows(void* dbproc, int32_t max_rows,
+///                             int64_t max_bytes, mssql_arena* arena)
+typedef _fetchRowsC =
+    Int32 Function(Pointer<Void>, Int32, Int64, Pointer<MssqlArena>);
+typedef _fetchRowsDart =
+    int Function(Pointer<Void>, int, int, Pointer<MssqlArena>);
+
+/// Values of [MssqlInterrupt.request] (MSSQL_INTERRUPT_*).
+const int kInterruptNone = 0;
+const int kInterruptCancelled = 1;
+const int kInterruptTimedOut = 2;
+
+/// C: struct mssql_interrupt — per-call cancellation slot polled by DB-Lib's
+/// interrupt handler while a statement waits on the server.
+///
+/// The caller's isolate writes [request]; the session sets [fired] once the
+/// attention has been sent. [deadline] is in Unix epoch milliseconds (0 for
+/// none).
+final class MssqlInterrupt extends Struct {
+  @Int32()
+  external int request;
+
+  @Int32()
+  external int fired;
+
+  @Int64()
+  external int deadline;
+}
+
+/// Whether the call owning [slot] should be abandoned. Latches
+/// [kInterruptTimedOut] once the deadline has passed, like the native
+/// interrupt check.
+bool interruptRequested(Pointer<MssqlInterrupt> slot) {
+  final s = slot.ref;
+  if (s.request == kInterruptNone &&
+      s.deadline > 0 &&
+      DateTime.now().millisecondsSinceEpoch >= s.deadline) {
+    s.request = kInterruptTimedOut;
+  }
+  return s.request != kInterruptNone;
+}
+
+/// C: void mssql_arm_interrupt(void* dbproc, mssql_interrupt* slot)
+typedef _armInterruptC = Void Function(Pointer<Void>, Pointer<MssqlInterrupt>);
+typedef _armInterruptDart =
+    void Function(Pointer<Void>, Pointer<MssqlInterrupt>);
+
+/// C: struct mssql_bcp_column — one bound column of a chunk sent by
+/// mssql_bcp_send_chunk.
+///
+/// Row `r` is `data[r * width, (r + 1) * width)` for fixed-width columns and
+/// `data[offsets[r], offsets[r + 1])` when [width] is 0; it is NULL when
+/// [nulls] is set and `nulls[r] != 0`.
+final class MssqlBcpColumn extends Struct {
+  @Int32()
+  external int hostType;
+
+  @Int32()
+  external int width;
+
+  external Pointer<Uint8> data;
+
+  external Pointer<Int64> offsets;
+
+  external Pointer<Uint8> nulls;
+}
+
+/// C: int32_t mssql_bcp_send_chunk(void* dbproc,
+///                                 const mssql_bcp_column* columns,
+///                                 int32_t ncols, int64_t first_row,
+///                                 int32_t rows, int32_t* failed_row)
+typedef _bcpSendChunkC =
+    Int32 Function(
+      Pointer<Void>,
+      Pointer<MssqlBcpColumn>,
+      Int32,
+      Int64,
+      Int32,
+      Pointer<Int32>,
+    );
+typedef _bcpSendChunkDart =
+    int Function(
+      Pointer<Void>,
+      Pointer<MssqlBcpColumn>,
+      int,
+      int,
+      int,
+      Pointer<Int32>,
+    );
+
+class MssqlNative {
+  final DynamicLibrary _lib;
+  late final _installHandlersDart mssql_install_handlers;
+  late final _takeTextDart mssql_take_last_error;
+  late final _takeTextDart mssql_take_last_message;
+  late final _arenaNewDart mssql_arena_new;
+  late final _arenaFreeDart mssql_arena_free;
+  late final _fetchRowsDart mssql_fetch_rows;
+  late final _armInterruptDart mssql_arm_interrupt;
+  late final _bcpSendChunkDart mssql_bcp_send_chunk;
+
+  MssqlNative._(this._lib) {
+    mssql_install_handlers = _lib
+        .lookupFunction<_installHandlersC, _installHandlersDart>(
+          'mssql_install_handlers',
+        );
+    mssql_take_last_error = _lib.lookupFunction<_takeTextC, _takeTextDart>(
+      'mssql_take_last_error',
+    );
+    mssql_take_last_message = _lib.lookupFunction<_takeTextC, _takeTextDart>(
+      'mssql_take_last_message',
+    );
+    mssql_arena_new = _lib.lookupFunction<_arenaNewC, _arenaNewDart>(
+      'mssql_arena_new',
+    );
+    mssql_arena_free = _lib.lookupFunction<_arenaFreeC, _arenaFreeDart>(
+      'mssql_arena_free',
+    );
+    mssql_fetch_rows = _lib.lookupFunction<_fetchRowsC, _fetchRowsDart>(
+      'mssql_fetch_rows',
+    );
+    mssql_arm_interrupt = _lib
+        .lookupFunction<_armInterruptC, _armInterruptDart>(
+          'mssql_arm_interrupt',
+        );
+    mssql_bcp_send_chunk = _lib
+        .lookupFunction<_bcpSendChunkC, _bcpSendChunkDart>(
+          'mssql_bcp_send_chunk',
+        );
+  }
+
+  static bool _probed = false;
+  static MssqlNative? _instance;
+
+  /// The helper library for this isolate, or null if it is not available
+  /// (missing library or ABI mismatch). Probed once per isolate.
+  static MssqlNative? get instance {
+    if (_probed) return _instance;
+    _probed = true;
+    try {
+      final lib = NativeLoader.loadMssqlNative();
+      if (lib == null) return null;
+      final abi = lib
+          .lookupFunction<_abiVersionC, _abiVersionDart>(
+            'mssql_native_abi_version',
+          )
+          .call();
+      if (abi != kMssqlNativeAbiVersion) {
+        NativeLogger.w(
+          'mssql_native: abi=$abi expected=$kMssqlNativeAbiVersion, ignoring',
+        );
+        return null;
+      }
+      _instance = MssqlNative._(lib);
+    } catch (e) {
+      NativeLogger.w('mssql_native: unavailable -> $e');
+      _instance = null;
+    }
+    return _instance;
+  }
+
+  static const int _textCap = 8192;
+
+  /// Take (and clear) the last DB-Lib error recorded for the DBPROCESS at
+  /// [dbprocAddress] (0 for library-level errors).
+  String? takeLastError(int dbprocAddress) =>
+      _take(mssql_take_last_error, dbprocAddress);
+
+  /// Take (and clear) the last server message recorded for the DBPROCESS at
+  /// [dbprocAddress].
+  String? takeLastMessage(int dbprocAddress) =>
+      _take(mssql_take_last_message, dbprocAddress);
+
+  String? _take(_takeTextDart fn, int dbprocAddress) {
+    final buf = malloc<Uint8>(_textCap);
+    try {
+      final n = fn(Pointer<Void>.fromAddress(dbprocAddress), buf, _textCap);
+      if (n < 0) return null;
+      final len = n < _textCap ? n : _textCap - 1;
+      return utf8.decode(buf.asTypedList(len), allowMalformed: true);
+    } finally {
+      malloc.free(buf);
+    }
+  }
+}
@@ -1,14 +1,21 @@
 import 'dart:async';
+import 'dart:collection';
 import 'dart:convert';
 import 'dart:ffi';
-import 'dart:io';
 import 'dart:math';
 import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
 
+import 'bcp_columns.dart';
+import 'bulk_options.dart';
+import 'columnar_builder.dart';
+import 'columnar_result.dart';
 import 'ffi/freetds_bindings.dart';
+import 'ffi/mssql_native_bindings.dart';
 import 'native_logger.dart';
+import 'result_set.dart';
+import 'row_reader.dart';
 import 'sql_exception.dart';
 
 class MssqlClient {
@@ -16,27 +23,50 @@ class MssqlClient {
   final String username;
   final String password;
 
+  /// How many prepared statement handles the session keeps (see
+  /// [queryParams] and [prepare]); 0 turns off handle reuse for
+  /// [queryParams].
+  final int statementCacheSize;
+
   DBLib? _db;
   Pointer<DBPROCESS>? _dbproc;
   bool _connected = false;
+  bool _nativeHandlers = false;
+  _Cursor? _cursor;
+  _BulkLoad? _bulk;
+  // Whether [_strictSetOptions] are known to be in effect on the session.
+  bool _strictSetActive = false;
+  int _packetSize = 0;
+  Pointer<MssqlInterrupt>? _interrupt;
+  // sp_prepare handles keyed by [_statementKey], least recently used first.
+  final LinkedHashMap<String, int> _statements = LinkedHashMap<String, int>();
 
   MssqlClient({
     required this.server,
     required this.username,
     required this.password,
+    this.statementCacheSize = 64,
   });
 
   bool get isConnected => _connected;
 
+  /// TDS packet size negotiated at login (`dbgetpacket`), or 0 before
+  /// [connect] has succeeded.
+  int get packetSize => _packetSize;
+
   /// Establish a DB-Lib connection to [server] using [username]/[password].
   ///
   /// Steps:
-  /// 1) Load and initialize DB-Lib (dbinit)
+  /// 1) Bind the shared DB-Lib (dbinit runs once per process; see
+  ///    [initialize])
   /// 1.1) Set login timeout via dbsetlogintime([loginTimeoutSeconds])
   /// 2) Allocate a LOGINREC (dblogin)
-  /// 3) Set credentials (dbsetluser/dbsetlpwd)
-  /// 4) Enable BCP option on the login (best-effort)
+  /// 3) Set credentials (dbsetluser/dbsetlpwd) and, when given, the initial
+  ///    [database] (DBSETDBNAME), so no `USE` round trip follows the login
+  /// 4) Enable BCP option on the login (best-effort) and request
+  ///    [packetSize] (DBSETPACKET) when given
   /// 5) Open a DBPROCESS to the server (dbopen)
+  /// 6) Raise the TEXT/NTEXT limit with one `SET TEXTSIZE` batch
   ///
   /// Returns true on success; false if any step fails. All native buffers
   /// for username/password/server are freed after use.
@@ -44,42 +74,26 @@ class MssqlClient {
   /// [loginTimeoutSeconds] controls how long DB-Lib waits to establish a socket
   /// connection/login before failing. Default is 15 seconds.
   ///
+  /// [packetSize] asks for TDS packets of that many bytes (512–32767)
+  /// instead of the server default (usually 4096). Larger packets mean
+  /// fewer network reads for big result sets and BCP loads. The server may
+  /// grant a different size; [packetSize] reports the one in effect.
+  ///
   /// Logging: emits lines in the form `connect | key=value | ...` for traceability.
-  Future<bool> connect({int loginTimeoutSeconds = 15}) async {
+  Future<bool> connect({
+    int loginTimeoutSeconds = 15,
+    String? database,
+    int? packetSize,
+  }) async {
     if (_connected) {
       MssqlLogger.i('connect | already-connected=true');
       return true;
     }
+    // Handles and SET options of an earlier session died with it.
+    _statements.clear();
+    _strictSetActive = false;
     try {
-      MssqlLogger.i('connect | op=init | status=start');
-      // Preflight: if server string looks like host:port, try a quick TCP probe
-      final hp = _splitHostPort(server);
-      if (hp != null) {
-        final ok = await _probeTcp(
-          hp.$1,
-          hp.$2,
-          Duration(seconds: loginTimeoutSeconds),
-        );
-        if (!ok) {
-          MssqlLogger.w(
-            'connect | op=probe | host=${hp.$1} | port=${hp.$2} | reachable=false',
-          );
-          return false;
-        }
-        MssqlLogger.i(
-          'connect | op=probe | host=${hp.$1} | port=${hp.$2} | reachable=true',
-        );
-      }
-      _db ??= DBLib.load();
-      _db!.dbinit();
-      // Install handlers early so DB-Lib won't use its default fatal handler on errors in dbopen.
-      try {
-        _db!.dberrhandle(kErrHandlerPtr);
-        _db!.dbmsghandle(kMsgHandlerPtr);
-        MssqlLogger.i('connect | op=handlers | status=installed');
-      } catch (e) {
-        MssqlLogger.w('connect | op=handlers | error=$e');
-      }
+      initialize();
 
       // Configure login timeout (best set before attempting to connect)
       try {
@@ -116,9 +130,20 @@ class MssqlClient {
           return false;
         }
 
+        if (database != null && database.isNotEmpty) {
+          final d = database.toNativeUtf8();
+          try {
+            final sd = _db!.dbsetlname(login, d, DBSETDBNAME);
+            MssqlLogger.i('connect | op=dbsetlname | option=DBSETDBNAME | rc=$sd');
+            if (sd != SUCCEED) return false;
+          } finally {
+            malloc.free(d);
+          }
+        }
+
         // Enable BCP on this login so that bulk insert APIs are available on the session.
         try {
-          final rcBcp = _db!.dbsetlbool(login, DBSETBCP, 1);
+          final rcBcp = _db!.dbsetlbool(login, 1, DBSETBCP);
           MssqlLogger.i(
             'connect | op=dbsetlbool | option=DBSETBCP | value=1 | rc=$rcBcp',
           );
@@ -127,6 +152,14 @@ class MssqlClient {
             'connect | op=dbsetlbool | option=DBSETBCP | value=1 | error=$e',
           );
         }
+
+        if (packetSize != null) {
+          final rc = _db!.dbsetllong(login, packetSize, DBSETPACKET);
+          MssqlLogger.i(
+            'connect | op=dbsetllong | option=DBSETPACKET | value=$packetSize | rc=$rc',
+          );
+          if (rc != SUCCEED) return false;
+        }
       } finally {
         malloc.free(u);
         malloc.free(p);
@@ -144,26 +177,17 @@ class MssqlClient {
         MssqlLogger.e('connect | op=dbopen | server=$server | error=nullptr');
         return false;
       }
+      _packetSize = _db!.dbgetpacket(_dbproc!);
+      MssqlLogger.i('connect | op=dbgetpacket | size=$_packetSize');
 
       // Increase TEXT/NTEXT retrieval limit to avoid 4096-byte default truncation.
-      // Use T-SQL SET TEXTSIZE to ensure compatibility across DB-Lib variants.
+      // This is one round trip. Queuing it with dbsetopt would not save it:
+      // dbsqlsend submits queued options as a query of their own before
+      // the next batch, and RPCs do not carry them at all.
       try {
-        const String cmdText = 'SET TEXTSIZE 2147483647';
-        final setPtr = cmdText.toNativeUtf8();
-        try {
-          final rc1 = _db!.dbcmd(_dbproc!, setPtr);
-          MssqlLogger.i('connect | op=dbcmd | sql=SET TEXTSIZE | rc=$rc1');
-          if (rc1 == SUCCEED) {
-            final rc2 = _db!.dbsqlexec(_dbproc!);
-            MssqlLogger.i('connect | op=dbsqlexec | rc=$rc2');
-            if (rc2 == SUCCEED) {
-              // Drain the SET batch quietly
-              _collectResults(_db!, _dbproc!);
-            }
-          }
-        } finally {
-          malloc.free(setPtr);
-        }
+        _sendBatch(_db!, _dbproc!, 'SET TEXTSIZE $_textSize');
+        final rs = _collectResults(_db!, _dbproc!);
+        MssqlLogger.i('connect | op=set-textsize | error=${rs.error ?? '-'}');
       } catch (e) {
         MssqlLogger.w('connect | op=set-textsize | error=$e');
       }
@@ -178,26 +202,25 @@ class MssqlClient {
     }
   }
 
-  // Parse a host:port string into (host, port). Returns null if not in that form.
-  (String, int)? _splitHostPort(String s) {
-    final idx = s.lastIndexOf(':');
-    if (idx <= 0 || idx == s.length - 1) return null;
-    final host = s.substring(0, idx);
-    final pStr = s.substring(idx + 1);
-    final port = int.tryParse(pStr);
-    if (port == null) return null;
-    return (host, port);
-  }
-
-  // Attempt a TCP connection to host:port within [timeout].
-  Future<bool> _probeTcp(String host, int port, Duration timeout) async {
+  /// Bind DB-Lib and point its error/message handlers at this isolate.
+  ///
+  /// The library, its symbols and dbinit are shared process state
+  /// ([DBLib.ensureInitialized]), so only the first client pays for them.
+  /// [connect] calls this itself; calling it earlier lets the work overlap
+  /// with other connect preparation (see `MssqlWorker.connect`).
+  void initialize() {
+    if (_db == null) {
+      MssqlLogger.i('connect | op=init | status=start');
+      _db = DBLib.ensureInitialized();
+    }
+    // Install handlers early so DB-Lib won't use its default fatal handler on errors in dbopen.
     try {
-      final sock = await Socket.connect(host, port, timeout: timeout);
-      // Immediately dispose; this is a reachability probe only.
-      await sock.close();
-      return true;
-    } catch (_) {
-      return false;
+      _nativeHandlers = _db!.installHandlers();
+      MssqlLogger.i(
+        'connect | op=handlers | status=installed | native=$_nativeHandlers',
+      );
+    } catch (e) {
+      MssqlLogger.w('connect | op=handlers | error=$e');
     }
   }
 
@@ -225,7 +248,12 @@ class MssqlClient {
       MssqlLogger.w('close | op=dbclose | error=$e');
     } finally {
       _dbproc = null;
+      _dropCursor();
+      _bulk = null;
+      _statements.clear();
+      _strictSetActive = false;
       _connected = false;
+      _packetSize = 0;
       MssqlLogger.i('close | status=disconnected');
     }
   }
@@ -236,51 +264,38 @@ class MssqlClient {
   /// If [columns] is not provided, the keys of the first row (iteration order)
   /// are used as the column order.
   /// Returns the number of rows successfully copied.
+  ///
+  /// [options] sets the load's hints and controls (see [BulkOptions]); they
+  /// are ignored for temp tables.
   Future<int> bulkInsert(
     String tableName,
     List<Map<String, dynamic>> rows, {
     List<String>? columns,
     int batchSize = 1000,
+    BulkOptions? options,
   }) async {
     _ensureConnected();
     if (rows.isEmpty) return 0;
     final db = _db!;
     final dbproc = _dbproc!;
 
-    // If inserting into a temp table (e.g., #tmp), fall back to parameterized INSERTs.
-    // BCP into temp tables is not consistently supported and can cause instability.
+    // If inserting into a temp table (e.g., #tmp), fall back to multi-row
+    // parameterized INSERTs. BCP into temp tables is not consistently
+    // supported and can cause instability.
     final tn = tableName.trim();
     if (tn.startsWith('#')) {
       final cols = (columns != null && columns.isNotEmpty)
           ? List<String>.from(columns)
           : rows.first.keys.toList(growable: false);
-      int total = 0;
-      for (final row in rows) {
-        final colList = cols
-            .map((c) => '[${c.replaceAll(']', ']]')}]')
-            .join(', ');
-        final placeholders = cols.map((c) => '@$c').join(', ');
-        final sql = 'INSERT INTO $tableName ($colList) VALUES ($placeholders)';
-        final pm = <String, dynamic>{};
-        for (final c in cols) {
-          pm['@$c'] = row[c];
-        }
-        final res = await executeParams(sql, pm);
-        try {
-          final j = jsonDecode(res);
-          final affected = (j['affected'] is int) ? j['affected'] as int : 0;
-          if (affected > 0) total += 1;
-        } catch (_) {
-          // On parse error, assume failure for that row
-        }
-      }
-      return total;
+      return _insertValues(tableName, rows, cols);
     }
 
     // Determine columns
     final cols = (columns != null && columns.isNotEmpty)
         ? List<String>.from(columns)
         : rows.first.keys.toList(growable: false);
+    // Host types come from the first row.
+    final hostTypes = <int>[for (final c in cols) _hostTypeFor(rows.first[c])];
 
     // Initialize BCP
     final tbl = tableName.toNativeUtf8();
@@ -289,83 +304,678 @@ class MssqlClient {
       if (rcInit != SUCCEED) {
         throw SQLException('bcp_init failed for $tableName');
       }
+    } finally {
+      malloc.free(tbl);
+    }
+
+    int total = 0;
+    try {
+      if (options != null) _applyBulkOptions(db, dbproc, options);
+      if (MssqlNative.instance != null) {
+        // Pack the rows column by column a chunk at a time and let the
+        // native helper send each chunk.
+        for (var start = 0; start < rows.length; start += _bcpChunkRows) {
+          final end = min(start + _bcpChunkRows, rows.length);
+          final chunk = BcpColumns.fromRows(rows, start, end, cols, hostTypes);
+          try {
+            // Binding once is enough: every sent row re-points the columns.
+            if (start == 0) _bindBcp(db, dbproc, chunk);
+            total += _sendBcpRows(db, dbproc, chunk, start, batchSize);
+          } finally {
+            chunk.dispose();
+          }
+        }
+      } else {
+        total = _sendBcpStaged(db, dbproc, rows, cols, hostTypes, batchSize);
+      }
+    } catch (_) {
+      _endBcp(db, dbproc, 'bulkInsert');
+      rethrow;
+    }
 
-      // Bind columns with host types; varaddr NULL, varlen -1, no terminator
-      final hostTypes = <int>[];
-      for (var i = 0; i < cols.length; i++) {
-        final sample = rows.first[cols[i]];
-        final htype = _hostTypeFor(sample);
-        hostTypes.add(htype);
-        final rcBind = db.bcp_bind(
-          dbproc,
-          nullptr,
-          0,
-          -1,
-          nullptr,
-          0,
-          htype,
-          i + 1,
-        );
-        if (rcBind != SUCCEED) {
-          throw SQLException('bcp_bind failed for column ${i + 1}');
+    // Finalize
+    final done = db.bcp_done(dbproc);
+    if (done < 0) {
+      throw SQLException('bcp_done failed');
+    }
+    total += done;
+    return total;
+  }
+
+  // End a load that failed or was interrupted after bcp_init. Until
+  // bcp_done runs the session is still in bulk-copy mode and every later
+  // command on it fails, so finish the load (rows already sent are kept)
+  // and fall back to dbcancel when bcp_done itself fails.
+  void _endBcp(DBLib db, Pointer<DBPROCESS> dbproc, String op) {
+    final done = db.bcp_done(dbproc);
+    final rc = done < 0 ? db.dbcancel(dbproc) : SUCCEED;
+    DBLib.takeLastError(dbproc);
+    DBLib.takeLastMessage(dbproc);
+    MssqlLogger.w('$op | status=ended-early | bcpDone=$done | dbcancel=$rc');
+  }
+
+  // Apply [options] to the load just initialized with bcp_init.
+  static void _applyBulkOptions(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    BulkOptions options,
+  ) {
+    if (options.keepIdentity &&
+        db.bcp_control(dbproc, BCPKEEPIDENTITY, 1) != SUCCEED) {
+      throw SQLException('bcp_control(BCPKEEPIDENTITY) failed');
+    }
+    final hints = options.hints;
+    if (hints.isEmpty) return;
+    final bytes = utf8.encode(hints);
+    final buf = malloc<Uint8>(bytes.length + 1);
+    try {
+      buf.asTypedList(bytes.length).setAll(0, bytes);
+      buf[bytes.length] = 0;
+      if (db.bcp_options(dbproc, BCPHINTS, buf, bytes.length) != SUCCEED) {
+        throw SQLException('bcp_options(BCPHINTS) failed: $hints');
+      }
+    } finally {
+      malloc.free(buf);
+    }
+  }
+
+  // Insert [rows] with `INSERT ... VALUES (...), (...)` statements of as many
+  // rows as fit in one RPC. Parameter types are fixed per column across all
+  // rows, so every full statement has the same text and reuses one cached
+  // handle. Returns the server's row counts.
+  int _insertValues(
+    String tableName,
+    List<Map<String, dynamic>> rows,
+    List<String> cols,
+  ) {
+    // sp_prepexec's handle, @params and @stmt count against the limit too.
+    const paramsPerStatement = _maxRpcParams - 3;
+    if (cols.length > paramsPerStatement) {
+      throw ArgumentError.value(
+        cols.length,
+        'columns',
+        'a #temp table load takes at most $paramsPerStatement columns per row',
+      );
+    }
+    final db = _db!;
+    final dbproc = _dbproc!;
+    final colList = cols.map((c) => '[${c.replaceAll(']', ']]')}]').join(', ');
+    final types = <String>[for (final c in cols) _columnSqlType(rows, c)];
+    final perStatement = min(
+      _maxValuesRows,
+      paramsPerStatement ~/ max(1, cols.length),
+    );
+    var total = 0;
+    for (var start = 0; start < rows.length; start += perStatement) {
+      final end = min(start + perStatement, rows.length);
+      final sql = StringBuffer('INSERT INTO $tableName ($colList) VALUES ');
+      final decl = <String, String>{};
+      final values = <Object?>[];
+      for (var r = start; r < end; r++) {
+        if (r > start) sql.write(', ');
+        sql.write('(');
+        for (var i = 0; i < cols.length; i++) {
+          final name = '@p${(r - start) * cols.length + i}';
+          if (i > 0) sql.write(', ');
+          sql.write(name);
+          decl[name] = types[i];
+          values.add(rows[r][cols[i]]);
         }
+        sql.write(')');
+      }
+      final ResultSet rs;
+      if (statementCacheSize > 0) {
+        rs = _executeStatement(sql.toString(), decl, values);
+      } else {
+        _sendExecuteSql(db, dbproc, sql.toString(), <String, dynamic>{
+          for (var k = 0; k < values.length; k++) '@p$k': values[k],
+        });
+        rs = _collectResults(db, dbproc);
+      }
+      if (rs.error != null) {
+        throw SQLException(DBLib.takeLastMessage(dbproc) ?? rs.error!);
+      }
+      total += rs.affected;
+      _pollInterrupt();
+    }
+    MssqlLogger.i(
+      'bulkInsert | op=values | cols=${cols.length} | rows=$total | perStatement=$perStatement',
+    );
+    return total;
+  }
+
+  // One declared type for column [col] of [rows]: that of its first non-null
+  // value, widened to bigint when any integer needs it and to nvarchar(max)
+  // when values disagree.
+  static String _columnSqlType(List<Map<String, dynamic>> rows, String col) {
+    String? type;
+    for (final row in rows) {
+      final v = row[col];
+      if (v == null) continue;
+      final t = _inferSqlType(v);
+      if (type == null || type == t) {
+        type = t;
+      } else if ((type == 'int' || type == 'bigint') &&
+          (t == 'int' || t == 'bigint')) {
+        type = 'bigint';
+      } else {
+        return 'nvarchar(max)';
+      }
+    }
+    return type ?? 'nvarchar(max)';
+  }
+
+  // Send [rows] through one persistent staging buffer per column; rows are
+  // encoded into them in place. Returns the rows committed by bcp_batch.
+  int _sendBcpStaged(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    List<Map<String, dynamic>> rows,
+    List<String> cols,
+    List<int> hostTypes,
+    int batchSize,
+  ) {
+    final stages = <_BcpStage>[];
+    try {
+      for (var i = 0; i < cols.length; i++) {
+        stages.add(_BcpStage.bind(db, dbproc, hostTypes[i], i + 1));
       }
 
       int sent = 0;
       int total = 0;
-
-      // Row buffers per column allocated per row (freed after send)
       for (final row in rows) {
-        final allocs = <_TempBuf>[];
-        try {
-          // Set data pointers/lengths for this row
-          for (var i = 0; i < cols.length; i++) {
-            final v = row[cols[i]];
-            if (v == null) {
-              // Indicate NULL
-              db.bcp_collen(dbproc, -1, i + 1);
-              db.bcp_colptr(dbproc, nullptr, i + 1);
-              continue;
-            }
-            final buf = _encodeForHost(hostTypes[i], v);
-            allocs.add(buf);
-            db.bcp_collen(dbproc, buf.length, i + 1);
-            db.bcp_colptr(dbproc, buf.ptr.cast<Uint8>(), i + 1);
-          }
+        for (var i = 0; i < cols.length; i++) {
+          stages[i].set(db, dbproc, row[cols[i]]);
+        }
 
-          // Send the row
-          final rcSend = db.bcp_sendrow(dbproc);
-          if (rcSend != SUCCEED) {
-            throw SQLException('bcp_sendrow failed');
-          }
-          sent++;
-
-          // Batch if needed
-          if (batchSize > 0 && (sent % batchSize == 0)) {
-            final b = db.bcp_batch(dbproc);
-            if (b < 0) {
-              throw SQLException('bcp_batch failed');
-            }
-            total += b;
+        // Send the row
+        final rcSend = db.bcp_sendrow(dbproc);
+        if (rcSend != SUCCEED) {
+          throw SQLException('bcp_sendrow failed');
+        }
+        sent++;
+        if (sent % _interruptStride == 0) _pollInterrupt();
+
+        // Batch if needed
+        if (batchSize > 0 && (sent % batchSize == 0)) {
+          final b = db.bcp_batch(dbproc);
+          if (b < 0) {
+            throw SQLException('bcp_batch failed');
           }
-        } finally {
-          // Free allocated buffers for this row
-          for (final a in allocs) {
-            malloc.free(a.ptr);
+          total += b;
+        }
+      }
+      return total;
+    } finally {
+      // DB-Lib reads the staging buffers only inside bcp_sendrow.
+      for (final st in stages) {
+        st.dispose();
+      }
+    }
+  }
+
+  void _bindBcp(DBLib db, Pointer<DBPROCESS> dbproc, BcpColumns source) {
+    try {
+      source.bind(db, dbproc);
+    } on StateError catch (e) {
+      throw SQLException(e.message);
+    }
+  }
+
+  // Send every row of [source] (bound like it) as rows [offset, offset + n)
+  // of the current load, committing a bcp_batch every [batchSize] rows of the
+  // load. Uses one native call per chunk when the helper is available.
+  // Returns the rows committed by bcp_batch.
+  int _sendBcpRows(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    BcpColumns source,
+    int offset,
+    int batchSize,
+  ) {
+    final native = MssqlNative.instance;
+    int total = 0;
+    var r = 0;
+    while (r < source.rowCount) {
+      var count = min(_bcpChunkRows, source.rowCount - r);
+      if (batchSize > 0) {
+        count = min(count, batchSize - (offset + r) % batchSize);
+      }
+      if (native != null) {
+        final (_, failed) = source.sendChunk(native, dbproc, r, count);
+        if (failed >= 0) {
+          final em =
+              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+          throw SQLException(
+            em ?? 'bcp_sendrow failed at row ${offset + r + failed}',
+          );
+        }
+      } else {
+        if (r == 0) source.prime(db, dbproc);
+        for (var i = r; i < r + count; i++) {
+          source.setRow(db, dbproc, i);
+          if (db.bcp_sendrow(dbproc) != SUCCEED) {
+            throw SQLException('bcp_sendrow failed at row ${offset + i}');
           }
+          if ((i + 1) % _interruptStride == 0) _pollInterrupt();
+        }
+      }
+      r += count;
+      _pollInterrupt();
+      if (batchSize > 0 && (offset + r) % batchSize == 0) {
+        final b = db.bcp_batch(dbproc);
+        if (b < 0) {
+          throw SQLException('bcp_batch failed');
+        }
+        total += b;
+      }
+    }
+    return total;
+  }
+
+  /// Start a bulk load into [tableName] that stays open across
+  /// [sendBulk] calls, so one BCP operation spans any number of row batches.
+  ///
+  /// Every row sent holds its values in [columns] order (table column order,
+  /// as for [bulkInsert]). A bcp_batch commits every [batchSize] rows of the
+  /// whole load. Other commands on this session throw [StateError] until
+  /// [endBulk] or [abortBulk]. [options] as for [bulkInsert].
+  ///
+  /// Logging: emits lines in the form `bulkStream | key=value | ...`.
+  Future<void> beginBulk(
+    String tableName,
+    List<String> columns, {
+    int batchSize = 1000,
+    BulkOptions? options,
+  }) async {
+    _ensureConnected();
+    if (columns.isEmpty) {
+      throw ArgumentError.value(columns, 'columns', 'must not be empty');
+    }
+    final tbl = tableName.toNativeUtf8();
+    try {
+      final rcInit = _db!.bcp_init(_dbproc!, tbl, nullptr, nullptr, DB_IN);
+      if (rcInit != SUCCEED) {
+        throw SQLException('bcp_init failed for $tableName');
+      }
+    } finally {
+      malloc.free(tbl);
+    }
+    if (options != null) {
+      try {
+        _applyBulkOptions(_db!, _dbproc!, options);
+      } catch (_) {
+        _endBcp(_db!, _dbproc!, 'bulkStream');
+        rethrow;
+      }
+    }
+    _bulk = _BulkLoad(List<String>.of(columns), batchSize);
+    MssqlLogger.i('bulkStream | op=begin | cols=${columns.length}');
+  }
+
+  /// Send positional [rows] on the load opened by [beginBulk]. Returns
+  /// `[rowsSent, rowsCommitted]` for the whole load so far. A failed or
+  /// interrupted send ends the load (see [abortBulk]).
+  ///
+  /// Host types are picked per column from the first non-null value of the
+  /// first rows sent; integers always travel as BIGINT so a later, wider
+  /// value cannot be truncated.
+  Future<List<int>> sendBulk(List<List<Object?>> rows) async {
+    final bulk = _bulk;
+    if (bulk == null) throw StateError('No bulk load is open');
+    _ensureConnected(allowBulk: true);
+    final db = _db!;
+    final dbproc = _dbproc!;
+    if (rows.isNotEmpty) {
+      final first = bulk.hostTypes == null;
+      final types = bulk.hostTypes ??= <int>[
+        for (var i = 0; i < bulk.columns.length; i++)
+          _streamHostType(rows, i),
+      ];
+      final source = BcpColumns.fromValues(bulk.columns, rows, types);
+      try {
+        if (first) _bindBcp(db, dbproc, source);
+        bulk.committed += _sendBcpRows(
+          db,
+          dbproc,
+          source,
+          bulk.sent,
+          bulk.batchSize,
+        );
+        bulk.sent += rows.length;
+      } catch (_) {
+        _bulk = null;
+        _endBcp(db, dbproc, 'bulkStream');
+        rethrow;
+      } finally {
+        source.dispose();
+      }
+    }
+    return <int>[bulk.sent, bulk.committed];
+  }
+
+  /// Finish the load opened by [beginBulk] (`bcp_done`) and return the
+  /// number of rows copied.
+  Future<int> endBulk() async {
+    final bulk = _bulk;
+    if (bulk == null) throw StateError('No bulk load is open');
+    _ensureConnected(allowBulk: true);
+    _bulk = null;
+    final done = _db!.bcp_done(_dbproc!);
+    if (done < 0) {
+      throw SQLException('bcp_done failed');
+    }
+    final total = bulk.committed + done;
+    MssqlLogger.i('bulkStream | op=end | rows=$total');
+    return total;
+  }
+
+  /// Abandon the load opened by [beginBulk] and leave bulk-copy mode so
+  /// the session takes commands again. Rows already sent are kept.
+  Future<void> abortBulk() async {
+    final bulk = _bulk;
+    if (bulk == null) return;
+    _bulk = null;
+    if (!_connected || _dbproc == null || _dbproc == nullptr) return;
+    MssqlLogger.w(
+      'bulkStream | op=abort | sent=${bulk.sent} | committed=${bulk.committed}',
+    );
+    _endBcp(_db!, _dbproc!, 'bulkStream');
+  }
+
+  static int _streamHostType(List<List<Object?>> rows, int col) {
+    for (final row in rows) {
+      final v = row[col];
+      if (v == null) continue;
+      return v is int ? SYBINT8 : _hostTypeFor(v);
+    }
+    return SYBNVARCHAR;
+  }
+
+  /// Bulk insert column-major data into [tableName].
+  ///
+  /// [columns] maps column name -> values for every row (see [BcpColumns]
+  /// for the accepted list types, e.g. `Int32List`, `Float64List`,
+  /// `List<String?>`). Each column is copied once into a native buffer that is
+  /// bound for the whole load; rows are sent by moving the bound pointers, so
+  /// no per-row maps or per-cell allocations are made. Temp tables take the
+  /// same parameterized fallback as [bulkInsert]. [options] as for
+  /// [bulkInsert].
+  /// Returns the number of rows copied.
+  Future<int> bulkInsertColumns(
+    String tableName,
+    Map<String, Object> columns, {
+    int batchSize = 1000,
+    BulkOptions? options,
+  }) async {
+    _ensureConnected();
+    final db = _db!;
+    final dbproc = _dbproc!;
+    final source = BcpColumns.fromMap(columns);
+    try {
+      if (source.rowCount == 0) return 0;
+      if (tableName.trim().startsWith('#')) {
+        return bulkInsert(
+          tableName,
+          List<Map<String, dynamic>>.generate(
+            source.rowCount,
+            source.rowAt,
+            growable: false,
+          ),
+          columns: source.names,
+          batchSize: batchSize,
+        );
+      }
+
+      final tbl = tableName.toNativeUtf8();
+      try {
+        final rcInit = db.bcp_init(dbproc, tbl, nullptr, nullptr, DB_IN);
+        if (rcInit != SUCCEED) {
+          throw SQLException('bcp_init failed for $tableName');
         }
+      } finally {
+        malloc.free(tbl);
+      }
+      int total;
+      try {
+        if (options != null) _applyBulkOptions(db, dbproc, options);
+        _bindBcp(db, dbproc, source);
+        total = _sendBcpRows(db, dbproc, source, 0, batchSize);
+      } catch (_) {
+        _endBcp(db, dbproc, 'bulkInsertColumns');
+        rethrow;
       }
 
-      // Finalize
       final done = db.bcp_done(dbproc);
       if (done < 0) {
         throw SQLException('bcp_done failed');
       }
       total += done;
+      MssqlLogger.i(
+        'bulkInsertColumns | status=done | cols=${source.names.length} | rows=$total',
+      );
       return total;
     } finally {
-      malloc.free(tbl);
+      source.dispose();
+    }
+  }
+
+  /// Insert or update [rows] in [tableName], matching on [keyColumns].
+  ///
+  /// The rows are bulk-loaded into a staging table shaped like the target
+  /// (`SELECT ... INTO`, without identity), then applied with one `MERGE`:
+  /// matched rows get [updateColumns] (default: every non-key column sent;
+  /// empty means insert-only) and the rest are inserted. Everything runs in
+  /// one transaction, under a savepoint when the caller already has one
+  /// open, so a failure leaves the target and the database unchanged and the
+  /// caller's transaction open (unless the error dooms it, in which case
+  /// the server only allows rolling it back entirely). Keys must be unique
+  /// within [rows].
+  ///
+  /// The staging table is a regular table rather than a `#temp` table so
+  /// it can be loaded through BCP; it is created inside the transaction,
+  /// so it cannot outlive the call even if the session dies.
+  ///
+  /// Logging: emits lines in the form `bulkUpsert | key=value | ...`.
+  Future<({int inserted, int updated})> bulkUpsert(
+    String tableName,
+    List<Map<String, dynamic>> rows,
+    List<String> keyColumns, {
+    List<String>? updateColumns,
+    List<String>? columns,
+    int batchSize = 1000,
+  }) async {
+    _ensureConnected();
+    if (keyColumns.isEmpty) {
+      throw ArgumentError.value(keyColumns, 'keyColumns', 'must not be empty');
+    }
+    if (rows.isEmpty) return (inserted: 0, updated: 0);
+    final cols = (columns != null && columns.isNotEmpty)
+        ? List<String>.from(columns)
+        : rows.first.keys.toList(growable: false);
+    for (final k in keyColumns) {
+      if (!cols.contains(k)) {
+        throw ArgumentError.value(k, 'keyColumns', 'is not a loaded column');
+      }
+    }
+    final updates =
+        updateColumns ??
+        cols.where((c) => !keyColumns.contains(c)).toList(growable: false);
+
+    String q(String c) => '[${c.replaceAll(']', ']]')}]';
+    final stage = q('__upsert_${_stageSuffix()}');
+    final colList = cols.map(q).join(', ');
+
+    Future<ResultSet> run(String sql) async {
+      final rs = await query(sql);
+      if (rs.error != null) {
+        throw SQLException(
+          DBLib.takeLastMessage(_dbproc!) ?? rs.error!,
+        );
+      }
+      return rs;
+    }
+
+    // Transaction depth the upsert runs at, so the error path undoes only
+    // its own level and never ends a transaction the caller opened.
+    final outer = await run('SELECT @@TRANCOUNT AS depth');
+    final level = (outer.rows.single[0] as num).toInt() + 1;
+    try {
+      // Inside the try: BEGIN TRAN and SAVE TRAN have run even when the
+      // SELECT INTO then fails (missing table, taken name, no permission).
+      await run(
+        'BEGIN TRAN; SAVE TRAN $_upsertSavepoint; '
+        'SELECT $colList INTO $stage FROM $tableName WHERE 1 = 0 '
+        'UNION ALL SELECT $colList FROM $tableName WHERE 1 = 0',
+      );
+      await bulkInsert(
+        stage,
+        rows,
+        columns: cols,
+        batchSize: batchSize,
+        options: const BulkOptions(tableLock: true),
+      );
+      final on = keyColumns.map((k) => 't.${q(k)} = s.${q(k)}').join(' AND ');
+      final set = updates.map((c) => 't.${q(c)} = s.${q(c)}').join(', ');
+      // TRY/CATCH stops the batch at the first error, before DROP and
+      // COMMIT, and leaves the rollback to the error path below.
+      final rs = await run(
+        'BEGIN TRY '
+        'DECLARE @actions TABLE (a NVARCHAR(10)); '
+        'MERGE $tableName WITH (HOLDLOCK) AS t USING $stage AS s ON $on '
+        '${updates.isEmpty ? '' : 'WHEN MATCHED THEN UPDATE SET $set '}'
+        'WHEN NOT MATCHED BY TARGET THEN INSERT ($colList) '
+        'VALUES (${cols.map((c) => 's.${q(c)}').join(', ')}) '
+        'OUTPUT \$action INTO @actions; '
+        "SELECT COUNT(CASE WHEN a = 'INSERT' THEN 1 END) AS inserted, "
+        "COUNT(CASE WHEN a = 'UPDATE' THEN 1 END) AS updated FROM @actions; "
+        'DROP TABLE $stage; COMMIT TRAN; '
+        'END TRY BEGIN CATCH THROW; END CATCH',
+      );
+      final counts = rs.rows.single;
+      final result = (
+        inserted: (counts[0] as num).toInt(),
+        updated: (counts[1] as num).toInt(),
+      );
+      MssqlLogger.i(
+        'bulkUpsert | status=done | rows=${rows.length} | inserted=${result.inserted} | updated=${result.updated}',
+      );
+      return result;
+    } catch (_) {
+      // Flush what the failed step left pending and roll back with the
+      // caller's interrupt disarmed, so a cancelled upsert is undone too.
+      final db = _db!;
+      final dbproc = _dbproc!;
+      db.dbcancel(dbproc);
+      if (_interrupt != null) {
+        _interrupt = null;
+        db.armInterrupt(dbproc, null);
+      }
+      try {
+        await query(
+          'IF XACT_STATE() = -1 ROLLBACK TRAN '
+          'ELSE IF XACT_STATE() = 1 AND @@TRANCOUNT >= $level '
+          'BEGIN ROLLBACK TRAN $_upsertSavepoint; COMMIT TRAN END',
+        );
+      } catch (e) {
+        MssqlLogger.w('bulkUpsert | op=rollback | error=$e');
+      }
+      rethrow;
+    }
+  }
+
+  /// Copy a table (or view), or the rows of a `SELECT`/`WITH` query, into
+  /// the file at [path] with BCP (`DB_OUT` / `DB_QUERYOUT`). DB-Lib streams
+  /// the rows straight to the file, so nothing is decoded in Dart.
+  ///
+  /// [format] picks native BCP format or [fieldTerminator]/[rowTerminator]
+  /// separated text (unquoted, so not CSV; see [BulkExportFormat.character]).
+  /// The file is written on this machine, not on the server. Returns the
+  /// number of rows copied. For rows wanted in memory, [queryColumnar]
+  /// fills typed column buffers instead.
+  ///
+  /// Logging: emits lines in the form `bulkExport | key=value | ...`.
+  Future<int> bulkExport(
+    String tableOrQuery,
+    String path, {
+    BulkExportFormat format = BulkExportFormat.native,
+    String fieldTerminator = ',',
+    String rowTerminator = '\n',
+  }) async {
+    _ensureConnected();
+    final isQuery = _isQueryText.hasMatch(tableOrQuery);
+    final ncols = await _exportColumnCount(
+      isQuery ? tableOrQuery : 'SELECT * FROM $tableOrQuery',
+    );
+    final db = _db!;
+    final dbproc = _dbproc!;
+    final source = tableOrQuery.toNativeUtf8();
+    final file = path.toNativeUtf8();
+    final field = _nativeBytes(utf8.encode(fieldTerminator));
+    final row = _nativeBytes(utf8.encode(rowTerminator));
+    final copied = malloc<Int32>();
+    try {
+      final rcInit = db.bcp_init(
+        dbproc,
+        source,
+        file,
+        nullptr,
+        isQuery ? DB_QUERYOUT : DB_OUT,
+      );
+      if (rcInit != SUCCEED || db.bcp_columns(dbproc, ncols) != SUCCEED) {
+        throw SQLException(
+          DBLib.takeLastError(dbproc) ?? 'bcp_init failed for $tableOrQuery',
+        );
+      }
+      for (var i = 1; i <= ncols; i++) {
+        final int rc;
+        if (format == BulkExportFormat.native) {
+          rc = db.bcp_colfmt(dbproc, i, 0, -1, -1, nullptr, -1, i);
+        } else {
+          final term = i == ncols ? row : field;
+          rc = db.bcp_colfmt(dbproc, i, SYBCHAR, 0, -1, term.$1, term.$2, i);
+        }
+        if (rc != SUCCEED) {
+          throw SQLException('bcp_colfmt failed for column $i');
+        }
+      }
+      copied.value = 0;
+      if (db.bcp_exec(dbproc, copied) != SUCCEED) {
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'bcp_exec failed for $tableOrQuery');
+      }
+      MssqlLogger.i(
+        'bulkExport | status=done | cols=$ncols | rows=${copied.value} | format=${format.name}',
+      );
+      return copied.value;
+    } finally {
+      malloc.free(source);
+      malloc.free(file);
+      malloc.free(field.$1);
+      malloc.free(row.$1);
+      malloc.free(copied);
+    }
+  }
+
+  // Number of visible columns [tsql] returns.
+  Future<int> _exportColumnCount(String tsql) async {
+    final rs = await queryParams(
+      'EXEC sp_describe_first_result_set @tsql = @tsql',
+      <String, dynamic>{'tsql': tsql},
+    );
+    if (rs.error != null) throw SQLException(rs.error!);
+    final hidden = rs.columns.indexOf('is_hidden');
+    final n = rs.rows.where((r) => hidden < 0 || r[hidden] != true).length;
+    if (n == 0) {
+      throw ArgumentError.value(tsql, 'tableOrQuery', 'returns no columns');
     }
+    return n;
+  }
+
+  static (Pointer<Uint8>, int) _nativeBytes(List<int> bytes) {
+    final p = malloc<Uint8>(bytes.isEmpty ? 1 : bytes.length);
+    p.asTypedList(bytes.length).setAll(0, bytes);
+    return (p, bytes.length);
   }
 
   /// Execute a plain SQL text command and return a JSON payload.
@@ -374,120 +984,369 @@ class MssqlClient {
   /// { columns: [..], rows: [ {col:val,..}, ..], affected: (int), error?: (string) }
   ///
   /// Logging: emits lines in the form `execute | key=value | ...`.
-  Future<String> execute(String sql) async {
+  Future<String> execute(String sql) async =>
+      (await query(sql)).toJsonString();
+
+  /// Execute a plain SQL text command and return its decoded [ResultSet]
+  /// (the same data as [execute], without the JSON encoding).
+  Future<ResultSet> query(String sql) async {
+    _ensureConnected();
+    _sendBatch(_db!, _dbproc!, sql);
+    return _collectResults(_db!, _dbproc!);
+  }
+
+  // Submit [sql] (preceded by the strict SET batch when needed) and leave its
+  // results pending on [dbproc].
+  void _sendBatch(DBLib db, Pointer<DBPROCESS> dbproc, String sql) {
+    // Re-prepare cached statements in the new database context after a
+    // batch that may switch databases.
+    if (_statements.isNotEmpty && _switchesDatabase(sql)) {
+      _unprepare(db, dbproc, _statements.values);
+      _statements.clear();
+    }
+    // DDL needs the strict SET options. They persist for the session, so
+    // they are sent (in a batch of their own: CREATE VIEW and the like must
+    // start their batch) only while the session is not known to have them.
+    if (!_strictSetActive && _isDdl(sql)) {
+      _submitBatch(db, dbproc, _strictSetOptions, what: ' (SET options)');
+      _strictSetActive = _collectResults(db, dbproc).error == null;
+    }
+    _submitBatch(db, dbproc, sql);
+    // A batch setting one of the options itself leaves their state unknown.
+    if (_strictSetActive && _setsStrictOption.hasMatch(sql)) {
+      _strictSetActive = false;
+    }
+  }
+
+  // dbcmd + dbsqlexec for [sql]; [what] qualifies the error message.
+  void _submitBatch(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    String sql, {
+    String what = '',
+  }) {
+    final cmd = sql.toNativeUtf8();
+    try {
+      MssqlLogger.i('execute | op=dbcmd | sqlLen=${sql.length}');
+      final rc1 = db.dbcmd(dbproc, cmd);
+      if (rc1 != SUCCEED) {
+        MssqlLogger.e('execute | op=dbcmd | rc=$rc1 | error=fail');
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbcmd failed$what');
+      }
+      MssqlLogger.i('execute | op=dbsqlexec');
+      final rc2 = db.dbsqlexec(dbproc);
+      if (rc2 != SUCCEED) {
+        MssqlLogger.e('execute | op=dbsqlexec | rc=$rc2 | error=fail');
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbsqlexec failed$what');
+      }
+    } finally {
+      malloc.free(cmd);
+    }
+  }
+
+  /// Execute parameterized SQL via DB-Lib RPC to sp_executesql and return JSON.
+  ///
+  /// - [sql]: text with @param placeholders (e.g., SELECT * FROM T WHERE c=@p)
+  /// - [params]: map of parameterName -> value (name can include or omit leading @)
+  ///
+  /// This uses the DB-Lib RPC path:
+  /// 1) dbrpcinit(dbproc, 'sp_executesql', 0)
+  /// 2) dbrpcparam for @stmt (NVARCHAR) and @params (NVARCHAR)
+  /// 3) dbrpcparam for each user parameter (typed, binary-safe)
+  /// 4) dbrpcsend + dbsqlok, then results are collected via [_collectResults].
+  ///
+  /// See [queryParams] for the decoded [ResultSet] without JSON encoding.
+  ///
+  /// Benefits: avoids string concatenation and quoting, preserves types, and
+  /// leverages the server to plan/execute with true parameters.
+  ///
+  /// Logging: emits lines in the form `executeParams | key=value | ...`.
+  Future<String> executeParams(String sql, Map<String, dynamic> params) async =>
+      (await queryParams(sql, params)).toJsonString();
+
+  /// Parameterized counterpart of [query]; see [executeParams].
+  ///
+  /// Unless [statementCacheSize] is 0, the statement is prepared on first use
+  /// (`sp_prepexec`, still one round trip) and its handle is cached per SQL
+  /// text and inferred parameter types, so repeated calls send only the
+  /// handle and the values through `sp_execute`.
+  Future<ResultSet> queryParams(String sql, Map<String, dynamic> params) async {
+    _ensureConnected();
+    if (statementCacheSize <= 0) {
+      _sendExecuteSql(_db!, _dbproc!, sql, params);
+      return _collectResults(_db!, _dbproc!);
+    }
+    final norm = _normalizeParams(params);
+    final types = <String, String>{
+      for (final e in norm.entries) e.key: _inferSqlType(e.value),
+    };
+    return _executeStatement(sql, types, norm.values.toList(growable: false));
+  }
+
+  /// Prepare [sql] with the declared [paramTypes] (name -> SQL type, e.g.
+  /// `{'@id': 'int', '@name': 'nvarchar(50)'}`, in parameter order) through
+  /// `sp_prepare`, and keep its handle in the session's statement cache.
+  ///
+  /// Logging: emits lines in the form `statements | key=value | ...`.
+  Future<void> prepare(String sql, Map<String, String> paramTypes) async {
     _ensureConnected();
     final db = _db!;
     final dbproc = _dbproc!;
-    // Detect if we should enable strict SET options for this statement
-    final _SetPlan plan = _analyzeSetNeeds(sql);
-    if (plan.needsSet) {
-      // 1) Enable options in their own batch
-      final setCmd = plan.setPrefix.toNativeUtf8();
-      try {
-        MssqlLogger.i('execute | op=dbcmd | sqlLen=${plan.setPrefix.length}');
-        final rc1 = db.dbcmd(dbproc, setCmd);
-        if (rc1 != SUCCEED) {
-          MssqlLogger.e('execute | op=dbcmd | rc=$rc1 | error=fail');
-          final em =
-              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
-          throw SQLException(em ?? 'dbcmd failed (SET options)');
-        }
-        MssqlLogger.i('execute | op=dbsqlexec');
-        final rc2 = db.dbsqlexec(dbproc);
-        if (rc2 != SUCCEED) {
-          MssqlLogger.e('execute | op=dbsqlexec | rc=$rc2 | error=fail');
-          final em =
-              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
-          throw SQLException(em ?? 'dbsqlexec failed (SET options)');
-        }
-        // Drain results for SET batch
-        _collectResults(db, dbproc);
-      } finally {
-        malloc.free(setCmd);
+    final types = _normalizeTypes(paramTypes);
+    final key = _statementKey(sql, types);
+    if (_touchStatement(key) != null) return;
+    _sendPreparedRpc(db, dbproc, 'sp_prepare', decl: _declare(types), sql: sql);
+    final rs = _collectResults(db, dbproc);
+    final handle = rs.error == null ? _readHandle(db, dbproc) : null;
+    if (handle == null) {
+      final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+      throw SQLException(em ?? rs.error ?? 'sp_prepare returned no handle');
+    }
+    _cacheStatement(db, dbproc, key, handle);
+    MssqlLogger.i('statements | op=prepare | handle=$handle');
+  }
+
+  /// Execute a statement declared like [prepare] with [params] bound by name.
+  ///
+  /// Sends only the cached handle and the values (`sp_execute`). When the
+  /// handle is gone (evicted, or the session reconnected) the statement is
+  /// prepared again in the same round trip (`sp_prepexec`).
+  Future<ResultSet> executePrepared(
+    String sql,
+    Map<String, String> paramTypes,
+    Map<String, dynamic> params,
+  ) async {
+    _ensureConnected();
+    final types = _normalizeTypes(paramTypes);
+    final norm = _normalizeParams(params);
+    for (final name in norm.keys) {
+      if (!types.containsKey(name)) {
+        throw ArgumentError.value(name, 'params', 'is not a declared parameter');
+      }
+    }
+    final values = <Object?>[];
+    for (final name in types.keys) {
+      if (!norm.containsKey(name)) {
+        throw ArgumentError.value(name, 'params', 'has no value');
       }
+      values.add(norm[name]);
+    }
+    return _executeStatement(sql, types, values);
+  }
 
-      // 2) Execute the original SQL in its own batch (ensuring CREATE VIEW is first)
-      final cmd = sql.toNativeUtf8();
-      try {
-        MssqlLogger.i('execute | op=dbcmd | sqlLen=${sql.length}');
-        final rc1 = db.dbcmd(dbproc, cmd);
-        if (rc1 != SUCCEED) {
-          MssqlLogger.e('execute | op=dbcmd | rc=$rc1 | error=fail');
-          final em =
-              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
-          throw SQLException(em ?? 'dbcmd failed');
-        }
-        MssqlLogger.i('execute | op=dbsqlexec');
-        final rc2 = db.dbsqlexec(dbproc);
-        if (rc2 != SUCCEED) {
-          MssqlLogger.e('execute | op=dbsqlexec | rc=$rc2 | error=fail');
-          final em =
-              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
-          throw SQLException(em ?? 'dbsqlexec failed');
+  /// Release the handle of a statement declared like [prepare]
+  /// (`sp_unprepare`). A no-op when it is not cached or the session is
+  /// closed, since handles die with their session.
+  Future<void> unprepare(String sql, Map<String, String> paramTypes) async {
+    if (!_connected || _dbproc == null || _dbproc == nullptr) return;
+    _ensureConnected();
+    final handle = _statements.remove(
+      _statementKey(sql, _normalizeTypes(paramTypes)),
+    );
+    if (handle != null) _unprepare(_db!, _dbproc!, <int>[handle]);
+  }
+
+  ResultSet _executeStatement(
+    String sql,
+    Map<String, String> types,
+    List<Object?> values,
+  ) {
+    final db = _db!;
+    final dbproc = _dbproc!;
+    final key = _statementKey(sql, types);
+    final handle = _touchStatement(key);
+    if (handle != null) {
+      _sendPreparedRpc(db, dbproc, 'sp_execute', handle: handle, values: values);
+      return _collectResults(db, dbproc);
+    }
+    _sendPreparedRpc(
+      db,
+      dbproc,
+      'sp_prepexec',
+      decl: _declare(types),
+      sql: sql,
+      values: values,
+    );
+    final rs = _collectResults(db, dbproc);
+    if (rs.error == null) {
+      final prepared = _readHandle(db, dbproc);
+      if (prepared != null) _cacheStatement(db, dbproc, key, prepared);
+    }
+    return rs;
+  }
+
+  static String _statementKey(String sql, Map<String, String> types) =>
+      '${_declare(types)}\u0000$sql';
+
+  // Cached handle for [key], marked most recently used.
+  int? _touchStatement(String key) {
+    final handle = _statements.remove(key);
+    if (handle != null) _statements[key] = handle;
+    return handle;
+  }
+
+  void _cacheStatement(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    String key,
+    int handle,
+  ) {
+    _statements[key] = handle;
+    final capacity = statementCacheSize < 1 ? 1 : statementCacheSize;
+    if (_statements.length <= capacity) return;
+    final evicted = <int>[];
+    while (_statements.length > capacity) {
+      evicted.add(_statements.remove(_statements.keys.first)!);
+    }
+    _unprepare(db, dbproc, evicted);
+  }
+
+  // Best-effort sp_unprepare of [handles] in one batch; the session must have
+  // no pending results.
+  void _unprepare(DBLib db, Pointer<DBPROCESS> dbproc, Iterable<int> handles) {
+    final sql = handles.map((h) => 'EXEC sp_unprepare $h;').join(' ');
+    if (sql.isEmpty) return;
+    final cmd = sql.toNativeUtf8();
+    try {
+      final ok =
+          db.dbcmd(dbproc, cmd) == SUCCEED && db.dbsqlexec(dbproc) == SUCCEED;
+      if (ok) {
+        while (db.dbresults(dbproc) == SUCCEED) {
+          _drainRows(db, dbproc);
         }
-        return _collectResults(db, dbproc);
-      } finally {
-        malloc.free(cmd);
       }
-    } else {
-      // Regular path
-      final cmd = sql.toNativeUtf8();
-      try {
-        MssqlLogger.i('execute | op=dbcmd | sqlLen=${sql.length}');
-        final rc1 = db.dbcmd(dbproc, cmd);
-        if (rc1 != SUCCEED) {
-          MssqlLogger.e('execute | op=dbcmd | rc=$rc1 | error=fail');
-          final em =
-              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
-          throw SQLException(em ?? 'dbcmd failed');
-        }
-        MssqlLogger.i('execute | op=dbsqlexec');
-        final rc2 = db.dbsqlexec(dbproc);
-        if (rc2 != SUCCEED) {
-          MssqlLogger.e('execute | op=dbsqlexec | rc=$rc2 | error=fail');
-          final em =
-              DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
-          throw SQLException(em ?? 'dbsqlexec failed');
+      MssqlLogger.i(
+        'statements | op=unprepare | count=${handles.length} | ok=$ok',
+      );
+    } finally {
+      malloc.free(cmd);
+    }
+  }
+
+  // The INT OUTPUT handle of sp_prepare/sp_prepexec; valid once all results
+  // have been read.
+  int? _readHandle(DBLib db, Pointer<DBPROCESS> dbproc) {
+    if (db.dbnumrets(dbproc) < 1) return null;
+    final ptr = db.dbretdata(dbproc, 1);
+    if (ptr == nullptr || db.dbretlen(dbproc, 1) != 4) return null;
+    return ptr.cast<Int32>().value;
+  }
+
+  // Send one of the sp_prepare family of RPCs with positional parameters:
+  // the handle (an INT OUTPUT when [handle] is null), then the declaration
+  // and statement text when [sql] is given, then [values] in declaration
+  // order. Results are left pending on [dbproc].
+  void _sendPreparedRpc(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    String rpc, {
+    int? handle,
+    String? decl,
+    String? sql,
+    List<Object?> values = const <Object?>[],
+  }) {
+    final rpcName = rpc.toNativeUtf8();
+    final handleBuf = malloc<Int32>();
+    final temps = <_TempBuf>[];
+
+    void param(int status, int type, int datalen, Pointer<Uint8> value) {
+      final rc = db.dbrpcparam(
+        dbproc,
+        nullptr, // positional
+        status,
+        type,
+        -1,
+        datalen,
+        value,
+      );
+      if (rc != SUCCEED) {
+        MssqlLogger.e('statements | op=dbrpcparam | rpc=$rpc | rc=$rc | error=fail');
+        try {
+          final z = ''.toNativeUtf8();
+          db.dbrpcinit(dbproc, z, DBRPCRESET);
+          malloc.free(z);
+        } catch (_) {}
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbrpcparam failed ($rpc)');
+      }
+    }
+
+    try {
+      final rcInit = db.dbrpcinit(dbproc, rpcName, 0);
+      if (rcInit != SUCCEED) {
+        MssqlLogger.e('statements | op=dbrpcinit | rpc=$rpc | rc=$rcInit | error=fail');
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbrpcinit failed ($rpc)');
+      }
+      if (handle == null) {
+        param(DBRPCRETURN, SYBINT4, 0, nullptr); // NULL in, handle out
+      } else {
+        handleBuf.value = handle;
+        param(0, SYBINT4, 4, handleBuf.cast<Uint8>());
+      }
+      if (sql != null) {
+        // Same length conventions as @params/@stmt in [_sendExecuteSql].
+        for (final text in <String>[decl ?? '', sql]) {
+          final b = _encodeStringSmart(text);
+          temps.add(b.buf);
+          param(
+            0,
+            b.type,
+            b.type == SYBNVARCHAR ? (b.buf.length >> 1) : b.buf.length,
+            b.buf.ptr,
+          );
         }
-        return _collectResults(db, dbproc);
-      } finally {
-        malloc.free(cmd);
       }
+      for (final v in values) {
+        final r = _encodeForRpc(v);
+        temps.add(r.buf);
+        param(
+          0,
+          r.type,
+          r.type == SYBNVARCHAR ? (r.buf.length << 1) : r.buf.length,
+          r.buf.ptr,
+        );
+      }
+
+      final rcSend = db.dbrpcsend(dbproc);
+      if (rcSend != SUCCEED) {
+        MssqlLogger.e('statements | op=dbrpcsend | rpc=$rpc | rc=$rcSend | error=fail');
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbrpcsend failed ($rpc)');
+      }
+      final rcOk = db.dbsqlok(dbproc);
+      if (rcOk != SUCCEED) {
+        MssqlLogger.e('statements | op=dbsqlok | rpc=$rpc | rc=$rcOk | error=fail');
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbsqlok failed ($rpc)');
+      }
+    } finally {
+      for (final t in temps) {
+        malloc.free(t.ptr);
+      }
+      malloc.free(handleBuf);
+      malloc.free(rpcName);
     }
   }
 
-  /// Execute parameterized SQL via DB-Lib RPC to sp_executesql and return JSON.
-  ///
-  /// - [sql]: text with @param placeholders (e.g., SELECT * FROM T WHERE c=@p)
-  /// - [params]: map of parameterName -> value (name can include or omit leading @)
-  ///
-  /// This uses the DB-Lib RPC path:
-  /// 1) dbrpcinit(dbproc, 'sp_executesql', 0)
-  /// 2) dbrpcparam for @stmt (NVARCHAR) and @params (NVARCHAR)
-  /// 3) dbrpcparam for each user parameter (typed, binary-safe)
-  /// 4) dbrpcsend + dbsqlok, then results are collected via [_collectResults].
-  ///
-  /// Benefits: avoids string concatenation and quoting, preserves types, and
-  /// leverages the server to plan/execute with true parameters.
-  ///
-  /// Logging: emits lines in the form `executeParams | key=value | ...`.
-  Future<String> executeParams(String sql, Map<String, dynamic> params) async {
-    _ensureConnected();
-    final db = _db!;
-    final dbproc = _dbproc!;
-
+  // Send the sp_executesql RPC for [sql]/[params] and leave its results
+  // pending on [dbproc].
+  void _sendExecuteSql(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    String sql,
+    Map<String, dynamic> params,
+  ) {
     // Normalize param names to include '@'
-    final norm = <String, dynamic>{};
-    params.forEach((k, v) => norm[_normalizeParamName(k)] = v);
+    final norm = _normalizeParams(params);
     MssqlLogger.i('executeParams | op=normalize | count=${norm.length}');
 
     // Build parameter declaration string (e.g., "@p1 int, @p2 nvarchar(max)")
-    final decls = <String>[];
-    for (final e in norm.entries) {
-      final declType = _inferSqlType(e.value);
-      decls.add('${e.key} $declType');
-    }
-    final declStr = decls.join(', ');
+    final declStr = _declare(
+      norm.map((k, v) => MapEntry(k, _inferSqlType(v))),
+    );
 
     // Prepare RPC call: sp_executesql(@stmt, @params, <params...>) with dynamic string encoding
     final rpcName = 'sp_executesql'.toNativeUtf8();
@@ -620,9 +1479,6 @@ class MssqlClient {
         final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
         throw SQLException(em ?? 'dbsqlok failed');
       }
-
-      // Read results via shared collector
-      return _collectResults(db, dbproc);
     } finally {
       // Free buffers for @stmt/@params and user param values
       malloc.free(stmtBuf.buf.ptr);
@@ -633,6 +1489,310 @@ class MssqlClient {
       malloc.free(rpcName);
     }
   }
+
+  /// Execute [sql] (through sp_executesql when [params] is given) and return
+  /// its first row-bearing result set in column-major typed buffers.
+  ///
+  /// Unlike [execute], no per-cell Dart objects or JSON text are produced for
+  /// numeric columns; see [ColumnarResult] for the layout. Later result sets
+  /// are drained and only contribute to `affected`.
+  ///
+  /// Logging: emits lines in the form `columnar | key=value | ...`.
+  Future<ColumnarResult> queryColumnar(
+    String sql, [
+    Map<String, dynamic>? params,
+  ]) async {
+    _ensureConnected();
+    final db = _db!;
+    final dbproc = _dbproc!;
+    if (params == null) {
+      _sendBatch(db, dbproc, sql);
+    } else {
+      _sendExecuteSql(db, dbproc, sql, params);
+    }
+    ColumnarBuilder? builder;
+    var affected = 0;
+    while (true) {
+      final r = db.dbresults(dbproc);
+      if (r == NO_MORE_RESULTS) break;
+      if (r != SUCCEED) {
+        MssqlLogger.e('columnar | op=dbresults | rc=$r | error=fail');
+        db.dbcancel(dbproc);
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbresults failed (rc=$r)');
+      }
+      if (builder == null && db.dbnumcols(dbproc) > 0) {
+        final b = builder = ColumnarBuilder.forResultSet(db, dbproc);
+        final reader = RowReader(db, dbproc);
+        try {
+          while (reader.next() == REG_ROW) {
+            b.addRow(db, dbproc, reader);
+          }
+        } finally {
+          reader.dispose();
+        }
+      } else {
+        _drainRows(db, dbproc);
+      }
+      affected += db.dbcount(dbproc);
+    }
+    final result = (builder ?? ColumnarBuilder.empty()).build(affected);
+    MssqlLogger.i(
+      'columnar | status=done | rows=${result.rowCount} | cols=${result.columns.length}',
+    );
+    return result;
+  }
+
+  /// Submit [sql] (through sp_executesql when [params] is given) and position
+  /// on its first result set that has columns, without fetching any rows.
+  ///
+  /// Returns that set's column names, or an empty list when the batch
+  /// produced no rows at all (nothing is left open in that case). Otherwise
+  /// read rows with [fetchCursor] until it returns null, or abandon the rest
+  /// with [closeCursor]. Other commands on this session throw [StateError]
+  /// while the cursor is open, because DB-Lib cannot interleave batches.
+  ///
+  /// Logging: emits lines in the form `cursor | key=value | ...`.
+  Future<List<String>> openCursor(
+    String sql, [
+    Map<String, dynamic>? params,
+  ]) async {
+    _ensureConnected();
+    final db = _db!;
+    final dbproc = _dbproc!;
+    if (params == null) {
+      _sendBatch(db, dbproc, sql);
+    } else {
+      _sendExecuteSql(db, dbproc, sql, params);
+    }
+    while (true) {
+      final r = db.dbresults(dbproc);
+      if (r == NO_MORE_RESULTS) {
+        MssqlLogger.i('cursor | op=open | status=no-rows');
+        return const <String>[];
+      }
+      if (r != SUCCEED) {
+        MssqlLogger.e('cursor | op=dbresults | rc=$r | error=fail');
+        db.dbcancel(dbproc);
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbresults failed (rc=$r)');
+      }
+      final ncols = db.dbnumcols(dbproc);
+      if (ncols <= 0) continue;
+      final columns = <String>[];
+      final types = List<int>.filled(ncols, 0);
+      for (var i = 1; i <= ncols; i++) {
+        final cptr = db.dbcolname(dbproc, i);
+        types[i - 1] = db.dbcoltype(dbproc, i);
+        columns.add(cptr == nullptr ? 'col$i' : cptr.toDartString());
+      }
+      _cursor = _Cursor(types, RowReader(db, dbproc));
+      MssqlLogger.i('cursor | op=open | ncols=$ncols');
+      return columns;
+    }
+  }
+
+  /// Fetch up to [maxRows] rows from the cursor opened by [openCursor].
+  ///
+  /// Each row is a list of values in column order. A batch shorter than
+  /// [maxRows] means the result set is exhausted; the cursor is then closed
+  /// (remaining result sets are drained) and later calls return null.
+  Future<List<List<Object?>>?> fetchCursor(int maxRows) async {
+    final cursor = _cursor;
+    if (cursor == null) return null;
+    _ensureConnected(allowCursor: true);
+    final db = _db!;
+    final dbproc = _dbproc!;
+    final types = cursor.types;
+    final reader = cursor.reader;
+    final ncols = types.length;
+    final rows = <List<Object?>>[];
+    while (rows.length < maxRows) {
+      final nr = reader.next();
+      if (nr == NO_MORE_ROWS) {
+        _finishCursor(db, dbproc);
+        break;
+      }
+      if (nr != REG_ROW) {
+        MssqlLogger.e('cursor | op=dbnextrow | rc=$nr | error=fail');
+        _dropCursor();
+        db.dbcancel(dbproc);
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbnextrow failed (rc=$nr)');
+      }
+      final row = List<Object?>.filled(ncols, null);
+      for (var i = 1; i <= ncols; i++) {
+        final len = reader.length(i);
+        final ptr = reader.data(i);
+        row[i - 1] = decodeDbValueWithFallback(
+          db,
+          dbproc,
+          types[i - 1],
+          ptr,
+          len,
+        );
+      }
+      rows.add(row);
+    }
+    cursor.fetched += rows.length;
+    return rows;
+  }
+
+  /// Abandon the cursor opened by [openCursor], discarding unread rows.
+  Future<void> closeCursor() async {
+    final cursor = _cursor;
+    if (cursor == null) return;
+    _dropCursor();
+    if (!_connected || _dbproc == null || _dbproc == nullptr) return;
+    final rc = _db!.dbcancel(_dbproc!);
+    MssqlLogger.i('cursor | op=dbcancel | fetched=${cursor.fetched} | rc=$rc');
+  }
+
+  // The streamed set is exhausted: drain any trailing result sets so the
+  // session is ready for the next command.
+  void _finishCursor(DBLib db, Pointer<DBPROCESS> dbproc) {
+    _dropCursor();
+    while (true) {
+      final r = db.dbresults(dbproc);
+      if (r != SUCCEED) break;
+      _drainRows(db, dbproc);
+    }
+    MssqlLogger.i('cursor | op=close | status=drained');
+  }
+
+  void _dropCursor() {
+    _cursor?.reader.dispose();
+    _cursor = null;
+  }
+
+  /// Run [body] (one client call) with [slot] armed as this session's
+  /// interrupt, so it can be abandoned by writing [MssqlInterrupt.request]
+  /// from another isolate or once [timeoutMs] (when > 0) has elapsed.
+  ///
+  /// DB-Lib polls the slot about once a second while it waits on the server,
+  /// and row and bulk loops check it every few hundred rows. When the call
+  /// was interrupted the remaining results are flushed with dbcancel, which
+  /// leaves the session reusable, and a [QueryCancelledException] or
+  /// [TimeoutException] is thrown instead of the call's own outcome.
+  ///
+  /// Logging: emits lines in the form `interrupt | key=value | ...`.
+  Future<T> interruptible<T>(
+    Pointer<MssqlInterrupt> slot,
+    int timeoutMs,
+    Future<T> Function() body,
+  ) async {
+    final db = _db;
+    final dbproc = _dbproc;
+    if (!_connected || db == null || dbproc == null || dbproc == nullptr) {
+      return body();
+    }
+    if (slot.ref.request != kInterruptNone) {
+      throw _interruptError(slot.ref.request, timeoutMs);
+    }
+    if (timeoutMs > 0) {
+      slot.ref.deadline = DateTime.now().millisecondsSinceEpoch + timeoutMs;
+    }
+    _interrupt = slot;
+    db.armInterrupt(dbproc, slot);
+    Object? failure;
+    StackTrace? failureTrace;
+    T? result;
+    try {
+      result = await body();
+    } catch (e, st) {
+      failure = e;
+      failureTrace = st;
+    } finally {
+      _interrupt = null;
+      db.armInterrupt(dbproc, null);
+    }
+    if (slot.ref.fired != 0) {
+      final rc = _dbproc == dbproc ? db.dbcancel(dbproc) : FAIL;
+      // The error store holds the timeout/attention noise; do not leak it
+      // into the next call's error message.
+      DBLib.takeLastError(dbproc);
+      DBLib.takeLastMessage(dbproc);
+      MssqlLogger.w(
+        'interrupt | request=${slot.ref.request} | timeoutMs=$timeoutMs | dbcancel=$rc',
+      );
+      throw _interruptError(slot.ref.request, timeoutMs);
+    }
+    if (failure != null) Error.throwWithStackTrace(failure, failureTrace!);
+    return result as T;
+  }
+
+  static Exception _interruptError(int request, int timeoutMs) =>
+      request == kInterruptTimedOut
+      ? TimeoutException(
+          'Query exceeded its timeout',
+          Duration(milliseconds: timeoutMs),
+        )
+      : QueryCancelledException();
+
+  // Called from long row loops (every [_interruptStride] rows): abandon the
+  // call once the armed interrupt has been requested. [interruptible] turns
+  // the throw into the proper exception.
+  void _pollInterrupt() {
+    final slot = _interrupt;
+    if (slot == null || !interruptRequested(slot)) return;
+    slot.ref.fired = 1;
+    throw StateError('interrupted');
+  }
+
+  static const int _interruptStride = 256;
+
+  // Rows per mssql_bcp_send_chunk call (and per packed chunk of bulkInsert).
+  static const int _bcpChunkRows = 2048;
+
+  // SQL Server accepts at most 2100 parameters per RPC.
+  static const int _maxRpcParams = 2100;
+
+  // SQL Server accepts at most 1000 row value expressions per VALUES clause.
+  static const int _maxValuesRows = 1000;
+
+  static const int _textSize = 2147483647;
+
+  static const String _upsertSavepoint = '__bulk_upsert';
+
+  static final Random _stageRandom = Random.secure();
+
+  // 128 random bits as hex, so staging tables of concurrent upserts (from
+  // any process or session) do not collide.
+  static String _stageSuffix() {
+    final out = StringBuffer();
+    for (var i = 0; i < 16; i++) {
+      out.write(_stageRandom.nextInt(256).toRadixString(16).padLeft(2, '0'));
+    }
+    return out.toString();
+  }
+
+  static final RegExp _isQueryText = RegExp(
+    r'^\s*(SELECT|WITH)\b',
+    caseSensitive: false,
+  );
+
+  static final RegExp _plainParamName = RegExp(r'^@[A-Za-z_#][\w@#$]*$');
+
+  // SET options DDL runs under (indexed views, computed column indexes and
+  // filtered indexes need them), applied once per session.
+  static const String _strictSetOptions =
+      'SET ANSI_NULLS ON; '
+      'SET QUOTED_IDENTIFIER ON; '
+      'SET ANSI_PADDING ON; '
+      'SET ANSI_WARNINGS ON; '
+      'SET CONCAT_NULL_YIELDS_NULL ON; '
+      'SET ARITHABORT ON; '
+      'SET NUMERIC_ROUNDABORT OFF;';
+
+  // A SET statement naming one of [_strictSetOptions] (or ANSI_DEFAULTS,
+  // which covers several), possibly in a comma-separated list.
+  static final RegExp _setsStrictOption = RegExp(
+    r'\bSET\s+(?:\w+\s*,\s*)*(?:ANSI_NULLS|QUOTED_IDENTIFIER|ANSI_PADDING|'
+    r'ANSI_WARNINGS|CONCAT_NULL_YIELDS_NULL|ARITHABORT|NUMERIC_ROUNDABORT|'
+    r'ANSI_DEFAULTS)\b',
+    caseSensitive: false,
+  );
+
   // --- Internals ---
 
   /// Collect rows and counts from the DB-Lib results pipeline.
@@ -647,10 +1807,12 @@ class MssqlClient {
   ///
   /// Logging: emits standardized lines prefixed with `collectResults`.
   ///
-  /// Returns JSON: { columns: [...], rows: [...], affected: (int), error?: (string) }
-  String _collectResults(DBLib db, Pointer<DBPROCESS> dbproc) {
-    final rows = <Map<String, dynamic>>[];
+  /// Returns a [ResultSet]; its JSON form is
+  /// { columns: [...], rows: [...], affected: (int), error?: (string) }
+  ResultSet _collectResults(DBLib db, Pointer<DBPROCESS> dbproc) {
+    final rows = <List<Object?>>[];
     final columns = <String>[];
+    final columnTypes = <int>[];
     int affectedTotal = 0;
     bool capturedFirstSet = false;
     String? error;
@@ -680,6 +1842,7 @@ class MssqlClient {
           final name = cptr == nullptr ? 'col$i' : cptr.toDartString();
           columns.add(name);
         }
+        columnTypes.addAll(types);
         capturedFirstSet = true;
         MssqlLogger.i('collectResults | op=columns | count=${columns.length}');
       }
@@ -687,27 +1850,7 @@ class MssqlClient {
       // Fetch rows only for the first schema-bearing result set
       int fetched = 0;
       if (ncols > 0 && capturedFirstSet && columns.isNotEmpty) {
-        while (true) {
-          final nr = db.dbnextrow(dbproc);
-          if (nr == NO_MORE_ROWS) break;
-          if (nr != REG_ROW && nr != MORE_ROWS) {
-            MssqlLogger.w(
-              'collectResults | op=dbnextrow | rc=$nr | warning=unexpected',
-            );
-            break;
-          }
-          final row = <String, dynamic>{};
-          for (var i = 1; i <= ncols; i++) {
-            final name = i <= columns.length ? columns[i - 1] : 'col$i';
-            final t = types[i - 1];
-            final len = db.dbdatlen(dbproc, i);
-            final ptr = db.dbdata(dbproc, i);
-            final v = decodeDbValueWithFallback(db, dbproc, t, ptr, len);
-            row[name] = v;
-          }
-          rows.add(row);
-          fetched++;
-        }
+        fetched = _readRows(db, dbproc, types, rows);
         MssqlLogger.i(
           'collectResults | op=rows | set=$setIndex | fetched=$fetched',
         );
@@ -716,12 +1859,7 @@ class MssqlClient {
         MssqlLogger.w(
           'collectResults | op=skip-rows | set=$setIndex | reason=secondary-schema',
         );
-        // Drain rows without collecting
-        while (true) {
-          final nr = db.dbnextrow(dbproc);
-          if (nr == NO_MORE_ROWS) break;
-          if (nr != REG_ROW && nr != MORE_ROWS) break;
-        }
+        _drainRows(db, dbproc);
       }
 
       // Accumulate affected rows for this set
@@ -736,27 +1874,295 @@ class MssqlClient {
       }
     }
 
-    final result = <String, dynamic>{
-      'columns': columns,
-      'rows': rows,
-      'affected': affectedTotal,
-    };
-    if (error != null) result['error'] = error;
     MssqlLogger.i(
       'collectResults | status=done | rows=${rows.length} | affected=$affectedTotal',
     );
-    return jsonEncode(result);
+    return ResultSet(
+      columns: columns,
+      columnTypes: columnTypes,
+      rows: rows,
+      affected: affectedTotal,
+      error: error,
+    );
+  }
+
+  /// Execute [sql] (through sp_executesql when [params] is given) and return
+  /// one [ResultSet] per result set that has columns, in server order.
+  ///
+  /// When [include] is given, only the sets at those 0-based positions are
+  /// decoded; the others are drained without touching their values and come
+  /// back with their columns and `affected` (the set's dbcount) but no rows.
+  /// Statements that produce no columns (e.g. DML) are not listed.
+  ///
+  /// Logging: emits lines in the form `executeMulti | key=value | ...`.
+  Future<List<ResultSet>> executeMulti(
+    String sql, {
+    Map<String, dynamic>? params,
+    Set<int>? include,
+  }) async {
+    _ensureConnected();
+    final db = _db!;
+    final dbproc = _dbproc!;
+    if (params == null) {
+      _sendBatch(db, dbproc, sql);
+    } else {
+      _sendExecuteSql(db, dbproc, sql, params);
+    }
+    final sets = <ResultSet>[];
+    while (true) {
+      final r = db.dbresults(dbproc);
+      if (r == NO_MORE_RESULTS) break;
+      if (r != SUCCEED) {
+        MssqlLogger.e('executeMulti | op=dbresults | rc=$r | error=fail');
+        db.dbcancel(dbproc);
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbresults failed (rc=$r)');
+      }
+      final ncols = db.dbnumcols(dbproc);
+      if (ncols <= 0) {
+        _drainRows(db, dbproc);
+        continue;
+      }
+      final index = sets.length;
+      final columns = <String>[];
+      final types = <int>[];
+      for (var i = 1; i <= ncols; i++) {
+        final cptr = db.dbcolname(dbproc, i);
+        columns.add(cptr == nullptr ? 'col$i' : cptr.toDartString());
+        types.add(db.dbcoltype(dbproc, i));
+      }
+      final rows = <List<Object?>>[];
+      final decode = include == null || include.contains(index);
+      if (decode) {
+        _readRows(db, dbproc, types, rows);
+      } else {
+        _drainRows(db, dbproc);
+      }
+      final count = db.dbcount(dbproc);
+      MssqlLogger.i(
+        'executeMulti | op=set | index=$index | ncols=$ncols | decoded=$decode | count=$count',
+      );
+      sets.add(
+        ResultSet(
+          columns: columns,
+          columnTypes: types,
+          rows: rows,
+          affected: count,
+        ),
+      );
+    }
+    MssqlLogger.i('executeMulti | status=done | sets=${sets.length}');
+    return sets;
+  }
+
+  /// Run the parameterized [sql] once per entry of [paramSets] and return
+  /// the rows affected by each run, in order.
+  ///
+  /// Up to [chunk] sets travel in a single `sp_executesql` RPC: the statement
+  /// text is sent once, every set is bound as its own group of parameters and
+  /// runs through a nested `sp_executesql`, and the per-set `@@ROWCOUNT`s come
+  /// back as one result set. A chunk is also capped so it stays under SQL
+  /// Server's 2100-parameter limit; a set with more than 2097 parameters is
+  /// rejected with [ArgumentError] before anything is sent. Chunks are not
+  /// atomic on their own; wrap the call in a transaction for all-or-nothing
+  /// behavior.
+  ///
+  /// Logging: emits lines in the form `executeBatch | key=value | ...`.
+  Future<List<int>> executeBatch(
+    String sql,
+    List<Map<String, dynamic>> paramSets, {
+    int chunk = 1000,
+  }) async {
+    _ensureConnected();
+    if (chunk < 1) {
+      throw ArgumentError.value(chunk, 'chunk', 'must be positive');
+    }
+    // sp_executesql's @stmt and @params and the nested '@__s' take three
+    // of the parameters, so no single set may bring more than the rest.
+    const perSet = _maxRpcParams - 3;
+    for (var i = 0; i < paramSets.length; i++) {
+      if (paramSets[i].length > perSet) {
+        throw ArgumentError(
+          'paramSets[$i] has ${paramSets[i].length} parameters; '
+          'a set takes at most $perSet',
+        );
+      }
+    }
+    final db = _db!;
+    final dbproc = _dbproc!;
+    final affected = <int>[];
+    var start = 0;
+    while (start < paramSets.length) {
+      var params = 3;
+      var end = start;
+      while (end < paramSets.length && end - start < chunk) {
+        final n = paramSets[end].length;
+        if (end > start && params + n > _maxRpcParams) break;
+        params += n;
+        end++;
+      }
+      final counts = _executeBatchChunk(
+        db,
+        dbproc,
+        sql,
+        paramSets.sublist(start, end),
+      );
+      if (counts.length != end - start) {
+        throw SQLException(
+          'executeBatch returned ${counts.length} counts for ${end - start} sets',
+        );
+      }
+      affected.addAll(counts);
+      MssqlLogger.i(
+        'executeBatch | op=chunk | sets=${end - start} | params=$params',
+      );
+      start = end;
+    }
+    MssqlLogger.i('executeBatch | status=done | sets=${affected.length}');
+    return affected;
+  }
+
+  List<int> _executeBatchChunk(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    String sql,
+    List<Map<String, dynamic>> sets,
+  ) {
+    final outer = <String, dynamic>{'@__s': sql};
+    final text = StringBuffer(
+      'DECLARE @__rc TABLE (i INT IDENTITY PRIMARY KEY, n INT);\n',
+    );
+    for (var i = 0; i < sets.length; i++) {
+      final norm = _normalizeParams(sets[i]);
+      final decl = <String, String>{};
+      final binds = <String>[];
+      for (final e in norm.entries) {
+        if (!_plainParamName.hasMatch(e.key)) {
+          throw ArgumentError.value(e.key, 'paramSets', 'invalid parameter name');
+        }
+        decl[e.key] = _inferSqlType(e.value);
+        final bound = '${e.key}__$i';
+        outer[bound] = e.value;
+        binds.add('${e.key} = $bound');
+      }
+      text.write('EXEC sp_executesql @__s');
+      if (binds.isNotEmpty) {
+        text
+          ..write(", N'")
+          ..write(_declare(decl).replaceAll("'", "''"))
+          ..write("', ")
+          ..write(binds.join(', '));
+      }
+      text.write(';\nINSERT @__rc (n) SELECT @@ROWCOUNT;\n');
+    }
+    text.write('SELECT n FROM @__rc ORDER BY i;');
+    _sendExecuteSql(db, dbproc, text.toString(), outer);
+
+    // The counts are the last row-bearing result set; anything the statement
+    // itself selects is skipped.
+    var counts = <int>[];
+    while (true) {
+      final r = db.dbresults(dbproc);
+      if (r == NO_MORE_RESULTS) break;
+      if (r != SUCCEED) {
+        MssqlLogger.e('executeBatch | op=dbresults | rc=$r | error=fail');
+        db.dbcancel(dbproc);
+        final em = DBLib.takeLastMessage(dbproc) ?? DBLib.takeLastError(dbproc);
+        throw SQLException(em ?? 'dbresults failed (rc=$r)');
+      }
+      final ncols = db.dbnumcols(dbproc);
+      if (ncols <= 0) {
+        _drainRows(db, dbproc);
+        continue;
+      }
+      final types = <int>[for (var c = 1; c <= ncols; c++) db.dbcoltype(dbproc, c)];
+      final rows = <List<Object?>>[];
+      _readRows(db, dbproc, types, rows);
+      counts = <int>[for (final row in rows) (row[0] as num?)?.toInt() ?? 0];
+    }
+    return counts;
+  }
+
+  // Decode every row of the current result set into [rows]; returns the
+  // number of rows read.
+  int _readRows(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    List<int> types,
+    List<List<Object?>> rows,
+  ) {
+    final ncols = types.length;
+    var fetched = 0;
+    final reader = RowReader(db, dbproc);
+    try {
+      while (true) {
+        final nr = reader.next();
+        if (nr == NO_MORE_ROWS) break;
+        if (nr != REG_ROW) {
+          MssqlLogger.w(
+            'collectResults | op=dbnextrow | rc=$nr | warning=unexpected',
+          );
+          break;
+        }
+        final row = List<Object?>.filled(ncols, null);
+        for (var i = 1; i <= ncols; i++) {
+          final t = types[i - 1];
+          final len = reader.length(i);
+          final ptr = reader.data(i);
+          row[i - 1] = decodeDbValueWithFallback(db, dbproc, t, ptr, len);
+        }
+        rows.add(row);
+        fetched++;
+        if (fetched % _interruptStride == 0) _pollInterrupt();
+      }
+    } finally {
+      reader.dispose();
+    }
+    return fetched;
+  }
+
+  // Skip the rows of the current result set without decoding them.
+  void _drainRows(DBLib db, Pointer<DBPROCESS> dbproc) {
+    while (true) {
+      final nr = db.dbnextrow(dbproc);
+      if (nr == NO_MORE_ROWS || nr == FAIL || nr == BUF_FULL) break;
+    }
   }
 
-  void _ensureConnected() {
+  void _ensureConnected({bool allowCursor = false, bool allowBulk = false}) {
     if (!_connected || _dbproc == null || _dbproc == nullptr) {
       throw SQLException('Not connected. Call connect() first.');
     }
+    if (_cursor != null && !allowCursor) {
+      throw StateError(
+        'A streamed query is still open on this session; '
+        'finish or cancel it first.',
+      );
+    }
+    if (_bulk != null && !allowBulk) {
+      throw StateError(
+        'A streamed bulk load is still open on this session; '
+        'finish or abort it first.',
+      );
+    }
+    // Dart handlers are isolate-bound; re-point DB-Lib's global handlers at
+    // this isolate in case another worker installed its own since.
+    if (!_nativeHandlers) _db!.installHandlers();
   }
 
   static String _normalizeParamName(String name) =>
       name.startsWith('@') ? name : '@$name';
 
+  static Map<String, dynamic> _normalizeParams(Map<String, dynamic> params) =>
+      params.map((k, v) => MapEntry(_normalizeParamName(k), v));
+
+  static Map<String, String> _normalizeTypes(Map<String, String> types) =>
+      types.map((k, v) => MapEntry(_normalizeParamName(k), v.trim()));
+
+  // "@p1 int, @p2 nvarchar(max)" for sp_executesql/sp_prepare.
+  static String _declare(Map<String, String> types) =>
+      types.entries.map((e) => '${e.key} ${e.value}').join(', ');
+
   static String _inferSqlType(dynamic v) {
     // For NULL values, avoid sql_variant which cannot implicitly convert to many types.
     // Use NVARCHAR(MAX) so NULL can bind safely to any nullable target type.
@@ -777,45 +2183,150 @@ class MssqlClient {
     return 'nvarchar(max)';
   }
 
-  // Analyze whether strict SET options are needed and generate the SET batch.
-  _SetPlan _analyzeSetNeeds(String sql) {
-    final trimmed = sql.trimLeft();
-    if (trimmed.isEmpty) return const _SetPlan(false, '');
-    final up = trimmed.toUpperCase();
-    final isDdl =
-        up.startsWith('CREATE ') ||
-        up.startsWith('ALTER ') ||
-        up.startsWith('DROP ');
-    final targetsStrict =
-        up.startsWith('CREATE VIEW ') ||
-        up.startsWith('ALTER VIEW ') ||
-        up.startsWith('CREATE TABLE ') ||
-        up.startsWith('ALTER TABLE ') ||
-        up.startsWith('CREATE INDEX ') ||
-        up.startsWith('ALTER INDEX ') ||
-        up.startsWith('CREATE FUNCTION ') ||
-        up.startsWith('ALTER FUNCTION ') ||
-        up.startsWith('CREATE PROCEDURE ') ||
-        up.startsWith('ALTER PROCEDURE ') ||
-        up.startsWith('CREATE TRIGGER ') ||
-        up.startsWith('ALTER TRIGGER ');
-    if (!(isDdl || targetsStrict)) return const _SetPlan(false, '');
-    const setPrefix =
-        'SET ANSI_NULLS ON; '
-        'SET QUOTED_IDENTIFIER ON; '
-        'SET ANSI_PADDING ON; '
-        'SET ANSI_WARNINGS ON; '
-        'SET CONCAT_NULL_YIELDS_NULL ON; '
-        'SET ARITHABORT ON; '
-        'SET NUMERIC_ROUNDABORT OFF;';
-    return const _SetPlan(true, setPrefix);
+  // Whether [sql] is DDL (CREATE, ALTER or DROP), judged by its first
+  // keyword after leading whitespace and comments. Only that word is
+  // examined, so long batches are not copied or upper-cased.
+  static bool _isDdl(String sql) {
+    final n = sql.length;
+    var i = 0;
+    while (i < n) {
+      final c = sql.codeUnitAt(i);
+      if (c == 0x20 || (c >= 0x09 && c <= 0x0D)) {
+        i++;
+      } else if (c == 0x2D && sql.startsWith('--', i)) {
+        final eol = sql.indexOf('\n', i);
+        if (eol < 0) return false;
+        i = eol + 1;
+      } else if (c == 0x2F && sql.startsWith('/*', i)) {
+        final close = sql.indexOf('*/', i + 2);
+        if (close < 0) return false;
+        i = close + 2;
+      } else {
+        break;
+      }
+    }
+    var j = i;
+    while (j < n && j - i <= 6 && _isWordChar(sql.codeUnitAt(j))) {
+      j++;
+    }
+    switch (sql.substring(i, j).toUpperCase()) {
+      case 'CREATE':
+      case 'ALTER':
+      case 'DROP':
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Whether [sql] holds a USE statement. Comments, string literals and
+  // quoted identifiers are skipped, so only the bare keyword counts, and
+  // USE HINT / USE PLAN (query hints) are not database switches.
+  static bool _switchesDatabase(String sql) {
+    final n = sql.length;
+    var afterUse = false;
+    var i = 0;
+    while (i < n) {
+      final c = sql.codeUnitAt(i);
+      if (c == 0x20 || (c >= 0x09 && c <= 0x0D)) {
+        i++;
+        continue;
+      }
+      if (c == 0x2D && sql.startsWith('--', i)) {
+        final eol = sql.indexOf('\n', i);
+        i = eol < 0 ? n : eol + 1;
+        continue;
+      }
+      if (c == 0x2F && sql.startsWith('/*', i)) {
+        i = _skipBlockComment(sql, i);
+        continue;
+      }
+      var j = i + 1;
+      String? word;
+      if (c == 0x27 || c == 0x22) {
+        j = _skipQuoted(sql, i, c);
+      } else if (c == 0x5B) {
+        j = _skipQuoted(sql, i, 0x5D);
+      } else if (_isNameChar(c)) {
+        while (j < n && _isNameChar(sql.codeUnitAt(j))) {
+          j++;
+        }
+        if (j - i <= 4) word = sql.substring(i, j).toUpperCase();
+      }
+      if (afterUse) {
+        if (word != 'HINT' && word != 'PLAN') return true;
+        afterUse = false;
+      } else {
+        afterUse = word == 'USE';
+      }
+      i = j;
+    }
+    return false;
+  }
+
+  // Index just past the string literal or quoted identifier opening at
+  // [start]; a doubled [close] is an escaped one.
+  static int _skipQuoted(String sql, int start, int close) {
+    var i = start + 1;
+    while (i < sql.length) {
+      if (sql.codeUnitAt(i) == close) {
+        if (i + 1 < sql.length && sql.codeUnitAt(i + 1) == close) {
+          i += 2;
+          continue;
+        }
+        return i + 1;
+      }
+      i++;
+    }
+    return sql.length;
+  }
+
+  // Index just past the block comment opening at [start]; T-SQL block
+  // comments nest.
+  static int _skipBlockComment(String sql, int start) {
+    var depth = 0;
+    var i = start;
+    while (i < sql.length) {
+      if (sql.startsWith('/*', i)) {
+        depth++;
+        i += 2;
+      } else if (sql.startsWith('*/', i)) {
+        i += 2;
+        if (--depth == 0) return i;
+      } else {
+        i++;
+      }
+    }
+    return sql.length;
   }
+
+  // Identifier characters, including the @, # and $ of variables and temp
+  // tables and any non-ASCII letter.
+  static bool _isNameChar(int c) =>
+      _isWordChar(c) || c == 0x40 || c == 0x23 || c == 0x24 || c >= 0x80;
+
+  static bool _isWordChar(int c) =>
+      (c >= 0x41 && c <= 0x5A) ||
+      (c >= 0x61 && c <= 0x7A) ||
+      (c >= 0x30 && c <= 0x39) ||
+      c == 0x5F;
 }
 
-class _SetPlan {
-  final bool needsSet;
-  final String setPrefix;
-  const _SetPlan(this.needsSet, this.setPrefix);
+class _BulkLoad {
+  final List<String> columns;
+  final int batchSize;
+  // Picked from the first rows sent.
+  List<int>? hostTypes;
+  int sent = 0;
+  int committed = 0;
+  _BulkLoad(this.columns, this.batchSize);
+}
+
+class _Cursor {
+  final List<int> types;
+  final RowReader reader;
+  int fetched = 0;
+  _Cursor(this.types, this.reader);
 }
 
 class _TempBuf {
@@ -842,61 +2353,123 @@ int _hostTypeFor(dynamic v) {
   return SYBNVARCHAR;
 }
 
-_TempBuf _encodeForHost(int hostType, dynamic v) {
-  switch (hostType) {
-    case SYBINT4:
-      {
-        final p = malloc<Int32>();
-        p.value = (v as int);
-        return _TempBuf(p.cast<Uint8>(), 4);
-      }
-    case SYBINT8:
-      {
-        final p = malloc<Int64>();
-        p.value = (v as int);
-        return _TempBuf(p.cast<Uint8>(), 8);
-      }
-    case SYBFLT8:
-      {
-        final p = malloc<Double>();
-        p.value = (v as double);
-        return _TempBuf(p.cast<Uint8>(), 8);
-      }
-    case SYBBIT:
-      {
-        final p = malloc<Uint8>();
-        p.value = (v as bool) ? 1 : 0;
-        return _TempBuf(p.cast<Uint8>(), 1);
-      }
-    case SYBVARBINARY:
-      {
-        final bytes = (v as Uint8List);
-        final p = malloc<Uint8>(bytes.length);
-        p.asTypedList(bytes.length).setAll(0, bytes);
-        return _TempBuf(p, bytes.length);
-      }
-    case SYBVARCHAR:
-    default:
-      {
-        // Encode as UTF-16LE for NVARCHAR host type; if type is actually SYBVARCHAR, SQL Server will convert.
-        final s = (v is String)
+// Native staging buffer for one bcp_bind'ed column of [MssqlClient.bulkInsert].
+//
+// Allocated once per load and bound as the column's varaddr; every row is
+// encoded into it in place, so sending a row costs no allocation. Only a
+// NULL, a change of length or a text/binary value outgrowing the buffer needs
+// an extra bcp_collen/bcp_colptr call.
+class _BcpStage {
+  final int hostType;
+  final int col;
+  Pointer<Uint8> _buf;
+  int _capacity;
+  // What DB-Lib currently points at: -1 for NULL, else the byte length.
+  int _len;
+
+  _BcpStage._(this.hostType, this.col, this._buf, this._capacity, this._len);
+
+  static int _fixedWidth(int hostType) {
+    switch (hostType) {
+      case SYBINT4:
+        return 4;
+      case SYBINT8:
+      case SYBFLT8:
+        return 8;
+      case SYBBIT:
+        return 1;
+      default:
+        return 0;
+    }
+  }
+
+  /// Allocate the buffer and bind it to 1-based column [col].
+  factory _BcpStage.bind(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    int hostType,
+    int col,
+  ) {
+    final width = _fixedWidth(hostType);
+    final capacity = width > 0 ? width : 256;
+    final buf = malloc<Uint8>(capacity);
+    final stage = _BcpStage._(hostType, col, buf, capacity, width);
+    final rc = db.bcp_bind(dbproc, buf, 0, -1, nullptr, 0, hostType, col);
+    if (rc != SUCCEED) {
+      stage.dispose();
+      throw SQLException('bcp_bind failed for column $col');
+    }
+    db.bcp_collen(dbproc, width, col);
+    return stage;
+  }
+
+  /// Encode [v] into the buffer as the value of the next row.
+  void set(DBLib db, Pointer<DBPROCESS> dbproc, Object? v) {
+    if (v == null) {
+      if (_len != -1) {
+        db.bcp_collen(dbproc, -1, col);
+        db.bcp_colptr(dbproc, nullptr, col);
+        _len = -1;
+      }
+      return;
+    }
+    var repoint = _len == -1;
+    final int len;
+    switch (hostType) {
+      case SYBINT4:
+        _buf.cast<Int32>().value = v as int;
+        len = 4;
+      case SYBINT8:
+        _buf.cast<Int64>().value = v as int;
+        len = 8;
+      case SYBFLT8:
+        _buf.cast<Double>().value = v as double;
+        len = 8;
+      case SYBBIT:
+        _buf.value = (v as bool) ? 1 : 0;
+        len = 1;
+      case SYBVARBINARY:
+        final bytes = v as Uint8List;
+        len = bytes.length;
+        repoint = _reserve(len) || repoint;
+        _buf.asTypedList(len).setAll(0, bytes);
+      default:
+        // UTF-16LE for the NVARCHAR host type; SQL Server converts as needed.
+        final str = (v is String)
             ? v
             : (v is DateTime)
             ? v.toIso8601String()
             : v.toString();
-        final codeUnits = s.codeUnits;
-        // Each code unit to 2 bytes LE
-        final len = codeUnits.length * 2;
-        final p = malloc<Uint8>(len);
-        final view = p.asTypedList(len);
-        for (int i = 0, j = 0; i < codeUnits.length; i++, j += 2) {
-          final cu = codeUnits[i];
+        len = str.length * 2;
+        repoint = _reserve(len) || repoint;
+        final view = _buf.asTypedList(len);
+        for (int i = 0, j = 0; i < str.length; i++, j += 2) {
+          final cu = str.codeUnitAt(i);
           view[j] = cu & 0xFF;
           view[j + 1] = (cu >> 8) & 0xFF;
         }
-        return _TempBuf(p, len);
-      }
+    }
+    if (repoint) db.bcp_colptr(dbproc, _buf, col);
+    if (len != _len) {
+      db.bcp_collen(dbproc, len, col);
+      _len = len;
+    }
   }
+
+  // Grow the buffer to hold [len] bytes; true when it moved.
+  bool _reserve(int len) {
+    if (len <= _capacity) return false;
+    var capacity = _capacity * 2;
+    while (capacity < len) {
+      capacity *= 2;
+    }
+    malloc.free(_buf);
+    _buf = malloc<Uint8>(capacity);
+    _capacity = capacity;
+    return true;
+  }
+
+  void dispose() => malloc.free(_buf);
 }
 
 // Map a Dart value to a DB-Lib type code and native buffer suitable for dbrpcparam.
@@ -1,14 +1,21 @@
 import 'dart:async';
 
-import 'mssql_client.dart';
+import 'bulk_options.dart';
+import 'cancellation_token.dart';
+import 'columnar_result.dart';
+import 'mssql_worker.dart';
+import 'result_set.dart';
 import 'native_logger.dart';
+import 'prepared_statement.dart';
+import 'row_batch.dart';
+import 'sql_exception.dart';
 
 class MssqlConnection {
   static final MssqlConnection _instance = MssqlConnection._internal();
   factory MssqlConnection.getInstance() => _instance;
   MssqlConnection._internal();
 
-  MssqlClient? _client;
+  MssqlWorker? _client;
 
   String? _ip;
   String? _port;
@@ -16,9 +23,40 @@ class MssqlConnection {
   String? _username;
   String? _password;
   int _timeoutInSeconds = 15;
+  bool _useWorkerIsolate = true;
+  int _statementCacheSize = 64;
+  bool _failFast = false;
+  int? _packetSize;
 
   bool get isConnected => _client?.isConnected == true;
 
+  /// TDS packet size granted by the server for the current session, or 0
+  /// when not connected. See the `packetSize` parameter of [connect].
+  int get packetSize => _client?.packetSize ?? 0;
+
+  /// Open a session to `ip:port` and switch to [databaseName].
+  ///
+  /// When [useWorkerIsolate] is true (default) every DB-Lib call for this
+  /// session runs on a dedicated worker isolate, so large fetches and bulk
+  /// loads do not block the calling isolate. Pass false to run DB-Lib inline
+  /// on the caller's isolate.
+  ///
+  /// [statementCacheSize] bounds how many prepared statement handles the
+  /// session keeps: parameterized calls are prepared once per SQL text and
+  /// parameter types and then executed by handle (see [prepare]). Pass 0 to
+  /// send every parameterized call through plain sp_executesql.
+  ///
+  /// With [failFast] the server is first checked with a TCP probe, and
+  /// connect returns false right away when nothing listens on `ip:port`
+  /// instead of waiting out the login timeout. Probe results are cached per
+  /// endpoint for a few seconds and the probe overlaps DB-Lib's
+  /// initialization. Off by default: the login itself detects an
+  /// unreachable server, and the probe costs an extra TCP handshake.
+  ///
+  /// [packetSize] requests TDS packets of that many bytes (512–32767)
+  /// instead of the server default, usually 4096. Larger packets cut the
+  /// number of network reads and writes for large result sets and bulk
+  /// loads; the size actually granted is reported by [packetSize].
   Future<bool> connect({
     required String ip,
     required String port,
@@ -26,6 +64,10 @@ class MssqlConnection {
     required String username,
     required String password,
     int timeoutInSeconds = 15,
+    bool useWorkerIsolate = true,
+    int statementCacheSize = 64,
+    bool failFast = false,
+    int? packetSize,
   }) async {
     // Basic input validation to prevent invalid dbopen calls and fail fast.
     final _ipTrim = ip.trim();
@@ -55,6 +97,10 @@ class MssqlConnection {
       MssqlLogger.w('connect(params) | invalid password (empty)');
       return false;
     }
+    if (packetSize != null && (packetSize < 512 || packetSize > 32767)) {
+      MssqlLogger.w('connect(params) | invalid packetSize (512-32767): $packetSize');
+      return false;
+    }
 
     _ip = _ipTrim;
     _port = _portTrim;
@@ -62,61 +108,245 @@ class MssqlConnection {
     _username = _userTrim;
     _password = _pwd;
     _timeoutInSeconds = _timeout;
+    _useWorkerIsolate = useWorkerIsolate;
+    _statementCacheSize = statementCacheSize;
+    _failFast = failFast;
+    _packetSize = packetSize;
 
     try {
       final server = '$_ipTrim:$_portTrim';
-      _client = MssqlClient(
+      // Release the previous session and its worker before opening a new one.
+      final previous = _client;
+      _client = null;
+      await previous?.dispose();
+      _client = await MssqlWorker.start(
         server: server,
         username: _userTrim,
         password: _pwd,
+        useIsolate: useWorkerIsolate,
+        statementCacheSize: statementCacheSize,
+      );
+      // The database travels in the login packet; the login fails when it
+      // does not exist or is not accessible.
+      return await _client!.connect(
+        loginTimeoutSeconds: _timeout,
+        database: databaseName,
+        packetSize: packetSize,
+        failFast: failFast,
       );
-      final ok = await _client!.connect(loginTimeoutSeconds: _timeout);
-      if (!ok) return false;
-
-      // Select database for this session.
-      if (databaseName.isNotEmpty) {
-        await _client!.execute('USE [${_escapeBrackets(databaseName)}]');
-        // If USE fails, subsequent queries will fail accordingly.
-        MssqlLogger.i('Switched database to $databaseName');
-      }
-      return true;
     } catch (e, st) {
       MssqlLogger.e('connect failed: $e\n$st');
       return false;
     }
   }
 
-  Future<String> getData(String query) async {
+  /// Run [query] and return its result as JSON text.
+  ///
+  /// [timeout] bounds how long the statement may run once it reaches the
+  /// session; [cancelToken] abandons it on demand. Either way the call fails
+  /// with [TimeoutException] or [QueryCancelledException] and the session is
+  /// flushed and stays usable. DB-Lib checks for both about once a second
+  /// while it waits on the server and every few hundred rows while reading.
+  /// Cancelling needs the default worker isolate: with
+  /// `useWorkerIsolate: false` the caller's isolate is blocked during the
+  /// call, so only [timeout] applies. The same parameters are accepted by
+  /// the other query methods and [bulkInsert].
+  Future<String> getData(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
     await _ensureConnectedOrReconnect();
-    return _client!.execute(query);
+    return _client!.execute(query, timeout: timeout, token: cancelToken);
   }
 
-  Future<String> writeData(String query) async {
+  Future<String> writeData(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
     await _ensureConnectedOrReconnect();
-    return _client!.execute(query);
+    return _client!.execute(query, timeout: timeout, token: cancelToken);
   }
 
   Future<String> getDataWithParams(
     String query,
-    Map<String, dynamic> params,
-  ) async {
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
     await _ensureConnectedOrReconnect();
-    return _client!.executeParams(query, params);
+    return _client!.executeParams(
+      query,
+      params,
+      timeout: timeout,
+      token: cancelToken,
+    );
   }
 
   Future<String> writeDataWithParams(
     String query,
-    Map<String, dynamic> params,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.executeParams(
+      query,
+      params,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Like [getData], but returns the decoded [ResultSet] instead of a JSON
+  /// string. Nothing is JSON-encoded unless [ResultSet.toJsonString] is
+  /// called, which saves the encode/decode round trip for Dart callers.
+  Future<ResultSet> getResultSet(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.query(query, timeout: timeout, token: cancelToken);
+  }
+
+  /// Like [getDataWithParams], but returns the decoded [ResultSet].
+  Future<ResultSet> getResultSetWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.queryParams(
+      query,
+      params,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Run the parameterized [query] once per entry of [paramSets] and return
+  /// the rows affected by each run.
+  ///
+  /// Instead of one round trip per set, up to [chunk] sets are sent in a
+  /// single `sp_executesql` call (fewer when needed to stay under SQL
+  /// Server's 2100-parameter limit). Chunks are not atomic; use
+  /// [beginTransaction] for all-or-nothing loads. See [getData] for
+  /// [timeout] and [cancelToken].
+  Future<List<int>> executeBatch(
+    String query,
+    List<Map<String, dynamic>> paramSets, {
+    int chunk = 1000,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.executeBatch(
+      query,
+      paramSets,
+      chunk: chunk,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Prepare [query] once on the server and return a [PreparedStatement]
+  /// that runs it by handle.
+  ///
+  /// [paramTypes] declares each parameter in order, name -> SQL type, e.g.
+  /// `{'@id': 'int', '@name': 'nvarchar(100)'}`. The handle survives
+  /// reconnects: after one, the next execute prepares the statement again.
+  Future<PreparedStatement> prepare(
+    String query,
+    Map<String, String> paramTypes,
   ) async {
     await _ensureConnectedOrReconnect();
-    return _client!.executeParams(query, params);
+    await _client!.prepare(query, paramTypes);
+    return PreparedStatement(query, paramTypes, (reconnect) async {
+      if (!reconnect) return isConnected ? _client : null;
+      await _ensureConnectedOrReconnect();
+      return _client;
+    });
+  }
+
+  /// Run [query] (e.g. a stored procedure or a multi-statement batch) and
+  /// return every result set that has columns, each with its own columns,
+  /// rows and row count, in a single round trip.
+  ///
+  /// Pass [sets] (0-based positions among those result sets) to decode only
+  /// what you need; the other sets are skipped without decoding and come
+  /// back with columns and `affected` but no rows. When [params] is given the
+  /// query runs through sp_executesql like [getDataWithParams].
+  Future<List<ResultSet>> executeMulti(
+    String query, {
+    Map<String, dynamic>? params,
+    Set<int>? sets,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.executeMulti(query, params: params, include: sets);
+  }
+
+  /// Run [query] and return its first row-bearing result set as one typed
+  /// buffer per column ([ColumnarResult]) instead of JSON text.
+  ///
+  /// Integer, floating-point and bit columns land in `Int32List`/`Int64List`/
+  /// `Float64List`/`Uint8List` buffers with a NULL bitmap; text and binary use
+  /// offsets into a byte buffer. Suited to pulling large numeric results
+  /// without allocating a Dart object per cell. When [params] is given the
+  /// query runs through sp_executesql like [getDataWithParams].
+  Future<ColumnarResult> queryColumnar(
+    String query, {
+    Map<String, dynamic>? params,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.queryColumnar(query, params);
+  }
+
+  /// Stream the rows of [query] in [RowBatch]es of up to [batchSize] rows
+  /// instead of materializing the whole result as one JSON string.
+  ///
+  /// Only the first result set that has columns is streamed. Rows are pulled
+  /// from the server as the subscriber consumes them: while the subscription
+  /// is paused no further rows are fetched, so memory stays bounded by one
+  /// batch however large the result is. When [params] is given the query runs
+  /// through sp_executesql like [getDataWithParams].
+  ///
+  /// No other call can use this connection until the stream completes or its
+  /// subscription is cancelled; such calls throw [StateError].
+  Stream<RowBatch> getDataStream(
+    String query, {
+    Map<String, dynamic>? params,
+    int batchSize = 1000,
+  }) async* {
+    await _ensureConnectedOrReconnect();
+    yield* _client!.stream(query, params: params, batchSize: batchSize);
   }
 
+  /// Row-at-a-time view of [getDataStream], keyed by column name.
+  Stream<Map<String, dynamic>> getRowStream(
+    String query, {
+    Map<String, dynamic>? params,
+    int batchSize = 1000,
+  }) => getDataStream(
+    query,
+    params: params,
+    batchSize: batchSize,
+  ).expand((batch) => batch.toMaps());
+
+  /// Bulk-load [rows] into [tableName] (see `getData` for [timeout] and
+  /// [cancelToken]; batches already committed stay when it is interrupted).
+  /// [options] requests server-side load hints such as `TABLOCK` or a
+  /// pre-sorted `ORDER`; see [BulkOptions].
   Future<int> bulkInsert(
     String tableName,
     List<Map<String, dynamic>> rows, {
     List<String>? columns,
     int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
   }) async {
     await _ensureConnectedOrReconnect();
     return _client!.bulkInsert(
@@ -124,12 +354,122 @@ class MssqlConnection {
       rows,
       columns: columns,
       batchSize: batchSize,
+      options: options,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Bulk-load column-major data into [tableName]: [columns] maps each column
+  /// name to all of its values, e.g. `{'id': Int32List, 'price':
+  /// Float64List, 'name': List<String?>}`. Each column is bound once as a
+  /// native buffer, so no per-row maps are built. Typed lists are never
+  /// NULL; use `List<int?>`, `List<double?>` etc. for nullable columns. See
+  /// [bulkInsert] for [timeout] and [cancelToken].
+  Future<int> bulkInsertColumns(
+    String tableName,
+    Map<String, Object> columns, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.bulkInsertColumns(
+      tableName,
+      columns,
+      batchSize: batchSize,
+      options: options,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Bulk-load a stream of [RowBatch]es into [tableName] through a single
+  /// BCP operation, so memory stays bounded by one batch however long the
+  /// stream is. Every batch must use the column names of the first.
+  ///
+  /// The next batch is not requested until the previous one has been sent,
+  /// and `bcp_batch` commits every [batchSize] rows of the whole load.
+  /// [onProgress] is called after each batch with the rows sent and
+  /// committed so far. If the stream fails or [cancelToken] fires, the load
+  /// is abandoned (committed batches stay) and the error is rethrown.
+  Future<int> bulkInsertStream(
+    String tableName,
+    Stream<RowBatch> rows, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    void Function(int sent, int committed)? onProgress,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.bulkInsertStream(
+      tableName,
+      rows,
+      batchSize: batchSize,
+      options: options,
+      onProgress: onProgress,
+      token: cancelToken,
+    );
+  }
+
+  /// Insert or update [rows] in [tableName] by [keyColumns]: the rows are
+  /// bulk-loaded into a staging table and applied with a single `MERGE` in
+  /// one transaction. Matched rows get [updateColumns] (default: all
+  /// non-key columns; empty for insert-only). Keys must be unique within
+  /// [rows]. See `getData` for [timeout] and [cancelToken]; an interrupted
+  /// upsert is rolled back.
+  Future<({int inserted, int updated})> bulkUpsert(
+    String tableName,
+    List<Map<String, dynamic>> rows,
+    List<String> keyColumns, {
+    List<String>? updateColumns,
+    List<String>? columns,
+    int batchSize = 1000,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.bulkUpsert(
+      tableName,
+      rows,
+      keyColumns,
+      updateColumns: updateColumns,
+      columns: columns,
+      batchSize: batchSize,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Copy a table, or the rows of a `SELECT`/`WITH` query, into the local
+  /// file at [path] through BCP, without decoding rows in Dart. See
+  /// [BulkExportFormat] for the file layouts and `getData` for [timeout]
+  /// and [cancelToken]. Returns the number of rows written.
+  Future<int> bulkExport(
+    String tableOrQuery,
+    String path, {
+    BulkExportFormat format = BulkExportFormat.native,
+    String fieldTerminator = ',',
+    String rowTerminator = '\n',
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    await _ensureConnectedOrReconnect();
+    return _client!.bulkExport(
+      tableOrQuery,
+      path,
+      format: format,
+      fieldTerminator: fieldTerminator,
+      rowTerminator: rowTerminator,
+      timeout: timeout,
+      token: cancelToken,
     );
   }
 
   Future<bool> disconnect() async {
     try {
-      await _client?.close();
+      await _client?.dispose();
       return true;
     } catch (_) {
       return false;
@@ -172,11 +512,17 @@ class MssqlConnection {
         username: _username!,
         password: _password!,
         timeoutInSeconds: _timeoutInSeconds,
+        useWorkerIsolate: _useWorkerIsolate,
+        statementCacheSize: _statementCacheSize,
+        failFast: _failFast,
+        packetSize: _packetSize,
       );
+      // A failed spawn leaves no client behind; surface it like a failed login.
+      if (_client == null) {
+        throw SQLException('Not connected. Call connect() first.');
+      }
       return;
     }
     throw StateError('Not connected. Call connect() first.');
   }
-
-  static String _escapeBrackets(String name) => name.replaceAll(']', ']]');
 }
@@ -0,0 +1,1025 @@
+import 'dart:async';
+import 'dart:collection';
+import 'dart:math';
+
+import 'bulk_options.dart';
+import 'cancellation_token.dart';
+import 'columnar_result.dart';
+import 'mssql_worker.dart';
+import 'native_logger.dart';
+import 'prepared_statement.dart';
+import 'result_set.dart';
+import 'row_batch.dart';
+import 'sql_exception.dart';
+
+/// Settings for [MssqlPool].
+class MssqlPoolConfig {
+  final String ip;
+  final String port;
+  final String databaseName;
+  final String username;
+  final String password;
+
+  /// Sessions kept open even when idle.
+  final int minSize;
+
+  /// Upper bound on open sessions (idle + in use + being opened).
+  final int maxSize;
+
+  /// Idle sessions above [minSize] are closed after this long unused.
+  final Duration idleTimeout;
+
+  /// Sessions are retired (on release or while idle) once this old.
+  final Duration maxLifetime;
+
+  /// Default deadline for [MssqlPool.acquire] when the pool is exhausted.
+  final Duration acquireTimeout;
+
+  /// Login timeout passed to each session's `dbsetlogintime`.
+  final int loginTimeoutSeconds;
+
+  /// Prepared statement handles each session keeps; see
+  /// `MssqlConnection.connect`.
+  final int statementCacheSize;
+
+  /// Check the server with a cached TCP probe before each login and fail
+  /// fast when it is unreachable; see `MssqlConnection.connect`.
+  final bool failFast;
+
+  /// TDS packet size each session requests at login (512–32767); null
+  /// keeps the server default. See `MssqlConnection.connect`.
+  final int? packetSize;
+
+  const MssqlPoolConfig({
+    required this.ip,
+    required this.port,
+    required this.databaseName,
+    required this.username,
+    required this.password,
+    this.minSize = 1,
+    this.maxSize = 4,
+    this.idleTimeout = const Duration(minutes: 5),
+    this.maxLifetime = const Duration(minutes: 30),
+    this.acquireTimeout = const Duration(seconds: 30),
+    this.loginTimeoutSeconds = 15,
+    this.statementCacheSize = 64,
+    this.failFast = false,
+    this.packetSize,
+  });
+}
+
+/// Point-in-time view of [MssqlPool] activity.
+class MssqlPoolMetrics {
+  /// Sessions currently borrowed.
+  final int inUse;
+
+  /// Open sessions waiting in the pool.
+  final int idle;
+
+  /// Sessions currently logging in.
+  final int opening;
+
+  /// Callers blocked in [MssqlPool.acquire].
+  final int waiters;
+
+  /// Successful acquisitions since the pool was opened.
+  final int acquired;
+
+  /// Acquisitions that hit their deadline.
+  final int timeouts;
+
+  final Duration averageAcquireLatency;
+  final Duration maxAcquireLatency;
+
+  const MssqlPoolMetrics({
+    required this.inUse,
+    required this.idle,
+    required this.opening,
+    required this.waiters,
+    required this.acquired,
+    required this.timeouts,
+    required this.averageAcquireLatency,
+    required this.maxAcquireLatency,
+  });
+
+  int get size => inUse + idle + opening;
+
+  @override
+  String toString() =>
+      'MssqlPoolMetrics(inUse: $inUse, idle: $idle, opening: $opening, '
+      'waiters: $waiters, acquired: $acquired, timeouts: $timeouts, '
+      'avgAcquire: ${averageAcquireLatency.inMicroseconds}us, '
+      'maxAcquire: ${maxAcquireLatency.inMicroseconds}us)';
+}
+
+/// A pool of independent SQL Server sessions.
+///
+/// Each session is its own DBPROCESS hosted on its own worker isolate, so
+/// statements on different sessions run in parallel.
+///
+/// Parallelism requires the mssql_native helper library, which is not
+/// built by `pub get`: build `native/` with CMake and place the library
+/// next to `libsybdb` (see the README). Without it DB-Lib's callbacks
+/// cannot be shared between isolates, so every session in the process
+/// takes turns on one queue and a pool behaves like a single connection;
+/// [open] prints a warning in that case. Check [runsInParallel].
+///
+/// ```dart
+/// final pool = await MssqlPool.open(MssqlPoolConfig(...));
+/// final json = await pool.withConnection((c) => c.getData('SELECT 1'));
+/// await pool.close();
+/// ```
+class MssqlPool {
+  final MssqlPoolConfig config;
+
+  // Idle sessions, least recently used first.
+  final ListQueue<_PooledSession> _idle = ListQueue<_PooledSession>();
+  final Set<_PooledSession> _busy = <_PooledSession>{};
+  final Queue<_Waiter> _waiters = Queue<_Waiter>();
+  int _opening = 0;
+  bool _closed = false;
+  Timer? _reaper;
+
+  int _acquired = 0;
+  int _timeouts = 0;
+  int _latencyTotalUs = 0;
+  int _latencyMaxUs = 0;
+
+  MssqlPool._(this.config);
+
+  /// Open a pool and log in [MssqlPoolConfig.minSize] sessions up front.
+  ///
+  /// Throws [ArgumentError] for inconsistent sizes or an out-of-range
+  /// packet size, and [SQLException] if the initial sessions cannot be
+  /// opened.
+  static Future<MssqlPool> open(MssqlPoolConfig config) async {
+    if (config.maxSize < 1) {
+      throw ArgumentError.value(config.maxSize, 'maxSize', 'must be >= 1');
+    }
+    if (config.minSize < 0 || config.minSize > config.maxSize) {
+      throw ArgumentError.value(
+        config.minSize,
+        'minSize',
+        'must be between 0 and maxSize (${config.maxSize})',
+      );
+    }
+    final packetSize = config.packetSize;
+    if (packetSize != null && (packetSize < 512 || packetSize > 32767)) {
+      throw ArgumentError.value(
+        packetSize,
+        'packetSize',
+        'must be between 512 and 32767',
+      );
+    }
+    final pool = MssqlPool._(config);
+    try {
+      await pool._fillToMin();
+    } catch (_) {
+      await pool.close();
+      rethrow;
+    }
+    pool._startReaper();
+    if (config.maxSize > 1 && !runsInParallel) _warnSerialized(config);
+    MssqlLogger.i(
+      'pool | op=open | min=${config.minSize} | max=${config.maxSize} | parallel=$runsInParallel',
+    );
+    return pool;
+  }
+
+  /// Whether sessions execute concurrently (requires the mssql_native helper).
+  static bool get runsInParallel => MssqlWorker.runsInParallel;
+
+  static bool _warnedSerialized = false;
+
+  // Printed once per process even with logging off: a pool that silently
+  // runs one statement at a time is easy to mistake for a slow server.
+  static void _warnSerialized(MssqlPoolConfig config) {
+    MssqlLogger.w('pool | op=open | max=${config.maxSize} | parallel=false');
+    if (_warnedSerialized) return;
+    _warnedSerialized = true;
+    // ignore: avoid_print
+    print(
+      '[MssqlPool][WARN ] mssql_native helper library not found: pooled '
+      'sessions will run one at a time. Build native/ with CMake and place '
+      'the library next to libsybdb to run them concurrently.',
+    );
+  }
+
+  bool get isClosed => _closed;
+
+  int get _size => _idle.length + _busy.length + _opening;
+
+  MssqlPoolMetrics get metrics => MssqlPoolMetrics(
+    inUse: _busy.length,
+    idle: _idle.length,
+    opening: _opening,
+    waiters: _waiters.length,
+    acquired: _acquired,
+    timeouts: _timeouts,
+    averageAcquireLatency: Duration(
+      microseconds: _acquired == 0 ? 0 : _latencyTotalUs ~/ _acquired,
+    ),
+    maxAcquireLatency: Duration(microseconds: _latencyMaxUs),
+  );
+
+  /// Borrow a session. Release it with [MssqlPooledConnection.release].
+  ///
+  /// Reuses an idle session, opens a new one while below
+  /// [MssqlPoolConfig.maxSize], or waits in FIFO order. Throws
+  /// [TimeoutException] if no session becomes available within [timeout]
+  /// (default [MssqlPoolConfig.acquireTimeout]).
+  Future<MssqlPooledConnection> acquire({Duration? timeout}) async {
+    if (_closed) throw StateError('MssqlPool is closed');
+    final sw = Stopwatch()..start();
+    final session = await _acquireSession(timeout ?? config.acquireTimeout);
+    sw.stop();
+    final us = sw.elapsedMicroseconds;
+    _acquired++;
+    _latencyTotalUs += us;
+    if (us > _latencyMaxUs) _latencyMaxUs = us;
+    return MssqlPooledConnection._(this, session);
+  }
+
+  /// Run [body] with a borrowed session and always release it afterwards.
+  Future<T> withConnection<T>(
+    Future<T> Function(MssqlPooledConnection conn) body, {
+    Duration? timeout,
+  }) async {
+    final conn = await acquire(timeout: timeout);
+    try {
+      return await body(conn);
+    } finally {
+      await conn.release();
+    }
+  }
+
+  /// See `MssqlConnection.getData`. [timeout] and [cancelToken] apply to the
+  /// statement only, not to the wait for a free connection (see [acquire]).
+  Future<String> getData(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.getData(query, timeout: timeout, cancelToken: cancelToken),
+  );
+
+  Future<String> writeData(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.writeData(query, timeout: timeout, cancelToken: cancelToken),
+  );
+
+  Future<String> getDataWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.getDataWithParams(
+      query,
+      params,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<String> writeDataWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.writeDataWithParams(
+      query,
+      params,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<ResultSet> getResultSet(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.getResultSet(query, timeout: timeout, cancelToken: cancelToken),
+  );
+
+  Future<ResultSet> getResultSetWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.getResultSetWithParams(
+      query,
+      params,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<int> bulkInsert(
+    String tableName,
+    List<Map<String, dynamic>> rows, {
+    List<String>? columns,
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.bulkInsert(
+      tableName,
+      rows,
+      columns: columns,
+      batchSize: batchSize,
+      options: options,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<int> bulkInsertColumns(
+    String tableName,
+    Map<String, Object> columns, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.bulkInsertColumns(
+      tableName,
+      columns,
+      batchSize: batchSize,
+      options: options,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<int> bulkInsertStream(
+    String tableName,
+    Stream<RowBatch> rows, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    void Function(int sent, int committed)? onProgress,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.bulkInsertStream(
+      tableName,
+      rows,
+      batchSize: batchSize,
+      options: options,
+      onProgress: onProgress,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<({int inserted, int updated})> bulkUpsert(
+    String tableName,
+    List<Map<String, dynamic>> rows,
+    List<String> keyColumns, {
+    List<String>? updateColumns,
+    List<String>? columns,
+    int batchSize = 1000,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.bulkUpsert(
+      tableName,
+      rows,
+      keyColumns,
+      updateColumns: updateColumns,
+      columns: columns,
+      batchSize: batchSize,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  Future<int> bulkExport(
+    String tableOrQuery,
+    String path, {
+    BulkExportFormat format = BulkExportFormat.native,
+    String fieldTerminator = ',',
+    String rowTerminator = '\n',
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => withConnection(
+    (c) => c.bulkExport(
+      tableOrQuery,
+      path,
+      format: format,
+      fieldTerminator: fieldTerminator,
+      rowTerminator: rowTerminator,
+      timeout: timeout,
+      cancelToken: cancelToken,
+    ),
+  );
+
+  /// Bulk-load [rows] into [tableName] over up to [connections] sessions at
+  /// once, each running its own BCP operation on a shard of the rows.
+  ///
+  /// Rows are dealt round-robin, or, with [keyColumn], sorted by that column
+  /// and split into contiguous key ranges so shards touch different parts of
+  /// a clustered index. [options] apply to every shard; left null, the
+  /// `TABLOCK` hint is used only when the table is a heap without indexes,
+  /// where bulk update locks of concurrent loads are compatible (on an
+  /// indexed table it would serialize the shards). The shard count is also capped by
+  /// [MssqlPoolConfig.maxSize]; sessions only load concurrently when
+  /// [runsInParallel].
+  ///
+  /// Returns the total rows copied. When any shard fails, the others still
+  /// run to completion and a [ParallelBulkInsertException] reports each
+  /// shard's count and error. Temp tables are per session and rejected.
+  Future<int> parallelBulkInsert(
+    String tableName,
+    List<Map<String, dynamic>> rows, {
+    int connections = 4,
+    String? keyColumn,
+    List<String>? columns,
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    if (tableName.trim().startsWith('#')) {
+      throw ArgumentError.value(
+        tableName,
+        'tableName',
+        'temp tables are not visible across sessions',
+      );
+    }
+    if (connections < 1) {
+      throw ArgumentError.value(connections, 'connections', 'must be positive');
+    }
+    if (rows.isEmpty) return 0;
+    final cols = (columns != null && columns.isNotEmpty)
+        ? columns
+        : rows.first.keys.toList(growable: false);
+    final opts =
+        options ?? BulkOptions(tableLock: await _isPlainHeap(tableName));
+    final shards = _shardRows(
+      rows,
+      min(connections, min(config.maxSize, rows.length)),
+      keyColumn,
+    );
+    MssqlLogger.i(
+      'pool | op=parallelBulkInsert | shards=${shards.length} | rows=${rows.length} | options=$opts',
+    );
+
+    final counts = List<int?>.filled(shards.length, null);
+    final errors = <int, Object>{};
+    await Future.wait(<Future<void>>[
+      for (var s = 0; s < shards.length; s++)
+        withConnection(
+          (c) => c._worker.bulkInsert(
+            tableName,
+            shards[s],
+            columns: cols,
+            batchSize: batchSize,
+            options: opts,
+            timeout: timeout,
+            token: cancelToken,
+          ),
+        ).then<void>(
+          (n) {
+            counts[s] = n;
+          },
+          onError: (Object e) {
+            errors[s] = e;
+          },
+        ),
+    ]);
+    if (errors.isNotEmpty) {
+      MssqlLogger.w(
+        'pool | op=parallelBulkInsert | failed=${errors.length}/${shards.length}',
+      );
+      throw ParallelBulkInsertException(counts, errors);
+    }
+    return counts.fold<int>(0, (a, n) => a + n!);
+  }
+
+  // Whether [tableName] is a heap with no indexes at all.
+  Future<bool> _isPlainHeap(String tableName) async {
+    final rs = await getResultSetWithParams(
+      'SELECT COUNT(*) FROM sys.indexes WHERE object_id = OBJECT_ID(@t) AND type <> 0',
+      {'t': tableName},
+    );
+    return rs.rows.single.single == 0;
+  }
+
+  static List<List<Map<String, dynamic>>> _shardRows(
+    List<Map<String, dynamic>> rows,
+    int n,
+    String? keyColumn,
+  ) {
+    if (keyColumn == null) {
+      return <List<Map<String, dynamic>>>[
+        for (var s = 0; s < n; s++)
+          <Map<String, dynamic>>[
+            for (var i = s; i < rows.length; i += n) rows[i],
+          ],
+      ];
+    }
+    final sorted = List<Map<String, dynamic>>.of(rows)
+      ..sort((a, b) {
+        final x = a[keyColumn] as Comparable?;
+        final y = b[keyColumn] as Comparable?;
+        if (x == null || y == null) {
+          return x == null ? (y == null ? 0 : -1) : 1;
+        }
+        return x.compareTo(y);
+      });
+    final size = (sorted.length + n - 1) ~/ n;
+    return <List<Map<String, dynamic>>>[
+      for (var start = 0; start < sorted.length; start += size)
+        sorted.sublist(start, min(start + size, sorted.length)),
+    ];
+  }
+
+  /// Close idle sessions, fail pending waiters and stop accepting acquires.
+  ///
+  /// Borrowed sessions are closed when they are released.
+  Future<void> close() async {
+    if (_closed) return;
+    _closed = true;
+    _reaper?.cancel();
+    _reaper = null;
+    while (_waiters.isNotEmpty) {
+      final w = _waiters.removeFirst();
+      w.fail(StateError('MssqlPool is closed'));
+    }
+    final idle = List<_PooledSession>.of(_idle);
+    _idle.clear();
+    await Future.wait(idle.map(_destroy));
+    MssqlLogger.i('pool | op=close | busy=${_busy.length}');
+  }
+
+  // --- Internals ---
+
+  Future<_PooledSession> _acquireSession(Duration timeout) async {
+    while (_idle.isNotEmpty) {
+      final s = _idle.removeLast();
+      if (_isStale(s, DateTime.now())) {
+        unawaited(_destroy(s));
+        continue;
+      }
+      _busy.add(s);
+      return s;
+    }
+    if (_size < config.maxSize) {
+      _opening++;
+      try {
+        final s = await _openSession();
+        _busy.add(s);
+        return s;
+      } finally {
+        _opening--;
+      }
+    }
+    final w = _Waiter();
+    w.timer = Timer(timeout, () {
+      _waiters.remove(w);
+      if (w.isDone) return;
+      _timeouts++;
+      MssqlLogger.w('pool | op=acquire | timeout=${timeout.inMilliseconds}ms');
+      w.fail(
+        TimeoutException('Timed out waiting for a pooled MSSQL session', timeout),
+      );
+    });
+    _waiters.add(w);
+    return w.completer.future;
+  }
+
+  // Return a session to the pool or hand it straight to the next waiter.
+  void _checkIn(_PooledSession s) {
+    _busy.remove(s);
+    if (_closed || _isStale(s, DateTime.now())) {
+      unawaited(_destroy(s));
+      _serviceWaiters();
+      return;
+    }
+    while (_waiters.isNotEmpty) {
+      final w = _waiters.removeFirst();
+      if (w.isDone) continue;
+      _busy.add(s);
+      w.succeed(s);
+      return;
+    }
+    s.lastUsed = DateTime.now();
+    _idle.addLast(s);
+  }
+
+  // Open sessions for waiters while there is spare capacity.
+  void _serviceWaiters() {
+    while (!_closed && _waiters.isNotEmpty && _size < config.maxSize) {
+      final w = _waiters.removeFirst();
+      if (w.isDone) continue;
+      _opening++;
+      _openSession().then(
+        (s) {
+          _opening--;
+          if (w.isDone) {
+            _checkIn(s);
+          } else {
+            _busy.add(s);
+            w.succeed(s);
+          }
+        },
+        onError: (Object e, StackTrace st) {
+          _opening--;
+          w.fail(e, st);
+        },
+      );
+    }
+  }
+
+  Future<void> _fillToMin() async {
+    final need = config.minSize - _size;
+    if (_closed || need <= 0) return;
+    _opening += need;
+    Object? lastError;
+    final opened = await Future.wait(
+      List.generate(
+        need,
+        (_) => _openSession().then<_PooledSession?>(
+          (s) => s,
+          onError: (Object e) {
+            MssqlLogger.w('pool | op=open-session | error=$e');
+            lastError = e;
+            return null;
+          },
+        ),
+      ),
+    );
+    _opening -= need;
+    for (final s in opened) {
+      if (s != null) _checkIn(s);
+    }
+    if (lastError != null) throw lastError!;
+  }
+
+  Future<_PooledSession> _openSession() async {
+    final server = '${config.ip}:${config.port}';
+    final worker = await MssqlWorker.start(
+      server: server,
+      username: config.username,
+      password: config.password,
+      statementCacheSize: config.statementCacheSize,
+    );
+    try {
+      final ok = await worker.connect(
+        loginTimeoutSeconds: config.loginTimeoutSeconds,
+        database: config.databaseName,
+        packetSize: config.packetSize,
+        failFast: config.failFast,
+      );
+      if (!ok) {
+        throw SQLException('Failed to open pooled session to $server');
+      }
+      MssqlLogger.i('pool | op=open-session | size=${_size + 1}');
+      return _PooledSession(worker);
+    } catch (_) {
+      await worker.dispose();
+      rethrow;
+    }
+  }
+
+  Future<void> _destroy(_PooledSession s) async {
+    try {
+      await s.worker.dispose();
+    } catch (e) {
+      MssqlLogger.w('pool | op=destroy | error=$e');
+    }
+  }
+
+  bool _isStale(_PooledSession s, DateTime now) =>
+      !s.worker.isConnected ||
+      now.difference(s.createdAt) >= config.maxLifetime;
+
+  void _startReaper() {
+    var ms = config.idleTimeout.inMilliseconds;
+    if (config.maxLifetime.inMilliseconds < ms) {
+      ms = config.maxLifetime.inMilliseconds;
+    }
+    ms = (ms ~/ 2).clamp(1000, 30000);
+    _reaper = Timer.periodic(Duration(milliseconds: ms), (_) => _reap());
+  }
+
+  // Retire idle sessions that are expired, broken, or idle beyond the timeout
+  // (never dropping below minSize for the latter), then top back up.
+  void _reap() {
+    if (_closed) return;
+    final now = DateTime.now();
+    var size = _size;
+    final keep = ListQueue<_PooledSession>();
+    for (final s in _idle) {
+      final idleTooLong =
+          now.difference(s.lastUsed) >= config.idleTimeout &&
+          size > config.minSize;
+      if (_isStale(s, now) || idleTooLong) {
+        size--;
+        unawaited(_destroy(s));
+      } else {
+        keep.addLast(s);
+      }
+    }
+    _idle
+      ..clear()
+      ..addAll(keep);
+    _fillToMin().catchError((Object e) {
+      MssqlLogger.w('pool | op=refill | error=$e');
+    });
+  }
+}
+
+/// A session borrowed from [MssqlPool].
+///
+/// Offers the same query API as `MssqlConnection`. Call [release] exactly
+/// once when done; the object must not be used afterwards.
+class MssqlPooledConnection {
+  final MssqlPool _pool;
+  final _PooledSession _session;
+  bool _released = false;
+
+  MssqlPooledConnection._(this._pool, this._session);
+
+  bool get isConnected => !_released && _session.worker.isConnected;
+
+  /// TDS packet size granted to this session; see
+  /// `MssqlConnection.packetSize`.
+  int get packetSize => _session.worker.packetSize;
+
+  MssqlWorker get _worker {
+    if (_released) throw StateError('Pooled connection already released');
+    return _session.worker;
+  }
+
+  /// See `MssqlConnection.getData` (also for [timeout] and [cancelToken]).
+  Future<String> getData(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.execute(query, timeout: timeout, token: cancelToken);
+
+  Future<String> writeData(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.execute(query, timeout: timeout, token: cancelToken);
+
+  Future<String> getDataWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.executeParams(
+    query,
+    params,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  Future<String> writeDataWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.executeParams(
+    query,
+    params,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.getResultSet`.
+  Future<ResultSet> getResultSet(
+    String query, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.query(query, timeout: timeout, token: cancelToken);
+
+  /// See `MssqlConnection.getResultSetWithParams`.
+  Future<ResultSet> getResultSetWithParams(
+    String query,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.queryParams(
+    query,
+    params,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.executeMulti`.
+  Future<List<ResultSet>> executeMulti(
+    String query, {
+    Map<String, dynamic>? params,
+    Set<int>? sets,
+  }) => _worker.executeMulti(query, params: params, include: sets);
+
+  /// See `MssqlConnection.executeBatch`.
+  Future<List<int>> executeBatch(
+    String query,
+    List<Map<String, dynamic>> paramSets, {
+    int chunk = 1000,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.executeBatch(
+    query,
+    paramSets,
+    chunk: chunk,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.prepare`. The statement is bound to this borrowed
+  /// session and cannot run after [release]; its handle stays in the
+  /// session's cache for the next borrower preparing the same statement.
+  Future<PreparedStatement> prepare(
+    String query,
+    Map<String, String> paramTypes,
+  ) async {
+    await _worker.prepare(query, paramTypes);
+    return PreparedStatement(
+      query,
+      paramTypes,
+      (reconnect) async =>
+          reconnect ? _worker : (_released ? null : _session.worker),
+    );
+  }
+
+  /// See `MssqlConnection.queryColumnar`.
+  Future<ColumnarResult> queryColumnar(
+    String query, {
+    Map<String, dynamic>? params,
+  }) => _worker.queryColumnar(query, params);
+
+  /// See `MssqlConnection.getDataStream`. Finish or cancel the stream before
+  /// calling [release].
+  Stream<RowBatch> getDataStream(
+    String query, {
+    Map<String, dynamic>? params,
+    int batchSize = 1000,
+  }) => _worker.stream(query, params: params, batchSize: batchSize);
+
+  Future<int> bulkInsert(
+    String tableName,
+    List<Map<String, dynamic>> rows, {
+    List<String>? columns,
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.bulkInsert(
+    tableName,
+    rows,
+    columns: columns,
+    batchSize: batchSize,
+    options: options,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.bulkInsertColumns`.
+  Future<int> bulkInsertColumns(
+    String tableName,
+    Map<String, Object> columns, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.bulkInsertColumns(
+    tableName,
+    columns,
+    batchSize: batchSize,
+    options: options,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.bulkInsertStream`.
+  Future<int> bulkInsertStream(
+    String tableName,
+    Stream<RowBatch> rows, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    void Function(int sent, int committed)? onProgress,
+    CancellationToken? cancelToken,
+  }) => _worker.bulkInsertStream(
+    tableName,
+    rows,
+    batchSize: batchSize,
+    options: options,
+    onProgress: onProgress,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.bulkUpsert`.
+  Future<({int inserted, int updated})> bulkUpsert(
+    String tableName,
+    List<Map<String, dynamic>> rows,
+    List<String> keyColumns, {
+    List<String>? updateColumns,
+    List<String>? columns,
+    int batchSize = 1000,
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.bulkUpsert(
+    tableName,
+    rows,
+    keyColumns,
+    updateColumns: updateColumns,
+    columns: columns,
+    batchSize: batchSize,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  /// See `MssqlConnection.bulkExport`.
+  Future<int> bulkExport(
+    String tableOrQuery,
+    String path, {
+    BulkExportFormat format = BulkExportFormat.native,
+    String fieldTerminator = ',',
+    String rowTerminator = '\n',
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) => _worker.bulkExport(
+    tableOrQuery,
+    path,
+    format: format,
+    fieldTerminator: fieldTerminator,
+    rowTerminator: rowTerminator,
+    timeout: timeout,
+    token: cancelToken,
+  );
+
+  Future<void> beginTransaction() async {
+    await writeData('BEGIN TRAN');
+  }
+
+  Future<void> commit() async {
+    await writeData('COMMIT');
+  }
+
+  Future<void> rollback() async {
+    await writeData('ROLLBACK');
+  }
+
+  /// Return the session to the pool. Idempotent.
+  ///
+  /// Any transaction still open on the session is rolled back first,
+  /// whether it came from [beginTransaction], raw `BEGIN TRAN` SQL or a
+  /// failed call; a session that cannot be rolled back is discarded. Pass
+  /// [discard] to close the session instead of reusing it.
+  Future<void> release({bool discard = false}) async {
+    if (_released) return;
+    _released = true;
+    final s = _session;
+    if (!discard) {
+      try {
+        await s.worker.execute('IF @@TRANCOUNT > 0 ROLLBACK');
+      } catch (e) {
+        MssqlLogger.w('pool | op=release | rollback-error=$e');
+        discard = true;
+      }
+    }
+    if (discard) {
+      _pool._busy.remove(s);
+      await _pool._destroy(s);
+      _pool._serviceWaiters();
+      return;
+    }
+    _pool._checkIn(s);
+  }
+}
+
+class _PooledSession {
+  final MssqlWorker worker;
+  final DateTime createdAt = DateTime.now();
+  DateTime lastUsed = DateTime.now();
+
+  _PooledSession(this.worker);
+}
+
+class _Waiter {
+  final Completer<_PooledSession> completer = Completer<_PooledSession>();
+  Timer? timer;
+
+  bool get isDone => completer.isCompleted;
+
+  void succeed(_PooledSession s) {
+    timer?.cancel();
+    completer.complete(s);
+  }
+
+  void fail(Object error, [StackTrace? st]) {
+    timer?.cancel();
+    if (!completer.isCompleted) completer.completeError(error, st);
+  }
+}
@@ -0,0 +1,912 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:ffi';
+import 'dart:isolate';
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'bulk_options.dart';
+import 'cancellation_token.dart';
+import 'columnar_result.dart';
+import 'ffi/freetds_bindings.dart';
+import 'ffi/mssql_native_bindings.dart';
+import 'mssql_client.dart';
+import 'native_loader.dart';
+import 'native_logger.dart';
+import 'result_set.dart';
+import 'row_batch.dart';
+import 'sql_exception.dart';
+import 'tcp_probe.dart';
+
+/// Runs an [MssqlClient] — and therefore every blocking DB-Lib call
+/// (dbsqlexec, dbresults, dbnextrow, bcp_sendrow, ...) — on a dedicated,
+/// long-lived worker isolate.
+///
+/// The worker owns the DBPROCESS for its whole lifetime. The caller's isolate
+/// only posts small command messages over a [SendPort] and receives results
+/// back as [TransferableTypedData], so a multi-second fetch never stalls the
+/// caller's event loop (e.g. a Flutter UI isolate).
+///
+/// With `useIsolate: false` the same command handler runs inline on the
+/// caller's isolate, which matches the historical in-process behavior.
+///
+/// Commands are executed strictly one at a time and in submission order,
+/// because a DBPROCESS cannot interleave batches.
+class MssqlWorker {
+  final String server;
+  final String username;
+  final String password;
+  final bool useIsolate;
+  final int statementCacheSize;
+
+  // Isolate mode
+  Isolate? _isolate;
+  SendPort? _commands;
+  ReceivePort? _replies;
+  ReceivePort? _exitPort;
+  final Map<int, Completer<Object?>> _pending = <int, Completer<Object?>>{};
+  int _nextId = 0;
+
+  // Inline mode
+  _WorkerHost? _inline;
+
+  bool _connected = false;
+  int _packetSize = 0;
+  bool _disposed = false;
+
+  MssqlWorker._({
+    required this.server,
+    required this.username,
+    required this.password,
+    required this.useIsolate,
+    required this.statementCacheSize,
+  });
+
+  bool get isConnected => _connected;
+
+  /// See [MssqlClient.packetSize]; 0 until [connect] succeeds.
+  int get packetSize => _packetSize;
+
+  /// Create a worker for the given credentials. No network traffic happens
+  /// until [connect] is called.
+  ///
+  /// When [useIsolate] is true (default) a worker isolate is spawned and its
+  /// command port is awaited before returning. [statementCacheSize] is
+  /// passed to [MssqlClient.statementCacheSize].
+  static Future<MssqlWorker> start({
+    required String server,
+    required String username,
+    required String password,
+    bool useIsolate = true,
+    int statementCacheSize = 64,
+  }) async {
+    final w = MssqlWorker._(
+      server: server,
+      username: username,
+      password: password,
+      useIsolate: useIsolate,
+      statementCacheSize: statementCacheSize,
+    );
+    if (!useIsolate) {
+      w._inline = _WorkerHost(
+        MssqlClient(
+          server: server,
+          username: username,
+          password: password,
+          statementCacheSize: statementCacheSize,
+        ),
+      );
+      MssqlLogger.i('worker | op=start | mode=inline');
+      return w;
+    }
+    _prepareLibrary();
+    await w._spawn();
+    return w;
+  }
+
+  // Locate DB-Lib and run dbinit once on this isolate. Both are process
+  // state, so workers open the remembered path directly and skip dbinit
+  // (see DBLib.adopt) instead of repeating the search.
+  static void _prepareLibrary() {
+    if (DBLib.initialized) return;
+    try {
+      DBLib.ensureInitialized();
+    } catch (e) {
+      // The worker retries on its own and reports the failure from connect.
+      MssqlLogger.w('worker | op=prepare-library | error=$e');
+    }
+  }
+
+  Future<void> _spawn() async {
+    final replies = ReceivePort('mssql-worker-replies');
+    final exitPort = ReceivePort('mssql-worker-exit');
+    _replies = replies;
+    _exitPort = exitPort;
+    final ready = Completer<SendPort>();
+
+    replies.listen((msg) {
+      if (msg is SendPort) {
+        if (!ready.isCompleted) ready.complete(msg);
+        return;
+      }
+      final m = msg as List<Object?>;
+      final c = _pending.remove(m[0] as int);
+      if (c == null) return;
+      if (m[1] == true) {
+        c.complete(_decodeReply(m[2]));
+      } else {
+        final err = m[2] as List<Object?>;
+        c.completeError(
+          _rebuildError(err[0] as String, err[1] as String),
+          StackTrace.fromString(err[2] as String? ?? ''),
+        );
+      }
+    });
+
+    exitPort.listen((_) {
+      MssqlLogger.w('worker | op=exit | pending=${_pending.length}');
+      _connected = false;
+      final err = StateError('MSSQL worker isolate exited');
+      for (final c in _pending.values) {
+        c.completeError(err);
+      }
+      _pending.clear();
+      if (!ready.isCompleted) ready.completeError(err);
+      _closePorts();
+    });
+
+    MssqlLogger.i('worker | op=spawn | server=$server');
+    _isolate = await Isolate.spawn<List<Object?>>(
+      _workerMain,
+      <Object?>[
+        replies.sendPort,
+        server,
+        username,
+        password,
+        MssqlLogger.enabled,
+        NativeLogger.enabled,
+        statementCacheSize,
+        NativeLoader.dbLibPath,
+        DBLib.initialized,
+      ],
+      onExit: exitPort.sendPort,
+      debugName: 'mssql-worker',
+    );
+    _commands = await ready.future;
+    MssqlLogger.i('worker | op=spawn | status=ready');
+  }
+
+  // Without the mssql_native handlers, DB-Lib's global error/message handlers
+  // point at whichever isolate installed them last, and invoking them from
+  // another isolate is fatal. In that case every worker created by this
+  // isolate funnels its commands through one shared queue.
+  static Future<void> _sharedTail = Future<void>.value();
+
+  /// Whether workers may run DB-Lib calls concurrently in this process.
+  static bool get runsInParallel => DBLib.hasNativeHandlers;
+
+  Future<Object?> _call(String op, [List<Object?> args = const []]) {
+    if (runsInParallel) return _dispatch(op, args);
+    final result = _sharedTail.then((_) => _dispatch(op, args));
+    _sharedTail = result.then<void>((_) {}, onError: (_) {});
+    return result;
+  }
+
+  Future<Object?> _dispatch(String op, List<Object?> args) {
+    if (_disposed) {
+      return Future.error(StateError('MSSQL worker has been disposed'));
+    }
+    final inline = _inline;
+    if (inline != null) return inline.run(op, args);
+    final port = _commands;
+    if (port == null) {
+      return Future.error(StateError('MSSQL worker isolate is not running'));
+    }
+    final id = _nextId++;
+    final c = Completer<Object?>();
+    _pending[id] = c;
+    port.send(<Object?>[id, op, args]);
+    return c.future;
+  }
+
+  // Run [op] under [MssqlClient.interruptible] when a [timeout] or [token] is
+  // given. The interrupt slot lives in native memory so [token] can trip it
+  // while the session's isolate is blocked inside DB-Lib; it is freed only
+  // after the reply arrives, by which time the session has disarmed it.
+  Future<Object?> _callInterruptible(
+    String op,
+    List<Object?> args, {
+    Duration? timeout,
+    CancellationToken? token,
+  }) async {
+    if (timeout == null && token == null) return _call(op, args);
+    if (token != null && token.isCancelled) throw QueryCancelledException();
+    final slot = calloc<MssqlInterrupt>();
+    final unregister = token?.register(() {
+      if (slot.ref.request == kInterruptNone) {
+        slot.ref.request = kInterruptCancelled;
+      }
+    });
+    try {
+      return await _call('interruptible', <Object?>[
+        slot.address,
+        // A zero or negative timeout still means "already expired".
+        timeout == null ? 0 : max(1, timeout.inMilliseconds),
+        op,
+        args,
+      ]);
+    } finally {
+      unregister?.call();
+      calloc.free(slot);
+    }
+  }
+
+  /// See [MssqlClient.connect].
+  ///
+  /// With [failFast] a `host:port` server is first checked with a TCP probe
+  /// ([TcpProbe], cached per endpoint for a few seconds) and connect returns
+  /// false without attempting the login when nothing answers. The probe runs
+  /// while the session loads and initializes DB-Lib, so a reachable server
+  /// costs no extra wait. Without it an unreachable server is reported by
+  /// DB-Lib once its login timeout expires.
+  Future<bool> connect({
+    int loginTimeoutSeconds = 15,
+    String? database,
+    int? packetSize,
+    bool failFast = false,
+  }) async {
+    final hp = failFast ? TcpProbe.splitHostPort(server) : null;
+    if (hp != null) {
+      final probe = TcpProbe.reachable(
+        hp.$1,
+        hp.$2,
+        // DB-Lib treats a login timeout of 0 as "no limit".
+        timeout: loginTimeoutSeconds > 0
+            ? Duration(seconds: loginTimeoutSeconds)
+            : null,
+      );
+      // A failure here surfaces, and is logged, again from connect below.
+      await _call('initialize').catchError((Object _) => null);
+      if (!await probe) {
+        MssqlLogger.w(
+          'worker | op=connect | host=${hp.$1} | port=${hp.$2} | reachable=false',
+        );
+        return false;
+      }
+    }
+    final ok =
+        await _call('connect', <Object?>[
+              loginTimeoutSeconds,
+              database,
+              packetSize,
+            ])
+            as bool;
+    _connected = ok;
+    _packetSize = ok ? await _call('packetSize') as int : 0;
+    return ok;
+  }
+
+  /// See [MssqlClient.execute].
+  ///
+  /// Every call taking [timeout]/[token] is abandoned once the timeout has
+  /// elapsed on the session or the token is cancelled, failing with
+  /// [TimeoutException] or [QueryCancelledException]; see
+  /// [MssqlClient.interruptible].
+  Future<String> execute(
+    String sql, {
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'execute',
+            <Object?>[sql],
+            timeout: timeout,
+            token: token,
+          )
+          as String;
+
+  /// See [MssqlClient.executeParams].
+  Future<String> executeParams(
+    String sql,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'executeParams',
+            <Object?>[sql, params],
+            timeout: timeout,
+            token: token,
+          )
+          as String;
+
+  /// See [MssqlClient.query].
+  Future<ResultSet> query(
+    String sql, {
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'query',
+            <Object?>[sql],
+            timeout: timeout,
+            token: token,
+          )
+          as ResultSet;
+
+  /// See [MssqlClient.queryParams].
+  Future<ResultSet> queryParams(
+    String sql,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'queryParams',
+            <Object?>[sql, params],
+            timeout: timeout,
+            token: token,
+          )
+          as ResultSet;
+
+  /// See [MssqlClient.executeBatch].
+  Future<List<int>> executeBatch(
+    String sql,
+    List<Map<String, dynamic>> paramSets, {
+    int chunk = 1000,
+    Duration? timeout,
+    CancellationToken? token,
+  }) async {
+    final counts = await _callInterruptible(
+      'executeBatch',
+      <Object?>[sql, paramSets, chunk],
+      timeout: timeout,
+      token: token,
+    );
+    return (counts as List).cast<int>();
+  }
+
+  /// See [MssqlClient.prepare].
+  Future<void> prepare(String sql, Map<String, String> paramTypes) =>
+      _call('prepare', <Object?>[sql, paramTypes]);
+
+  /// See [MssqlClient.executePrepared].
+  Future<ResultSet> executePrepared(
+    String sql,
+    Map<String, String> paramTypes,
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'executePrepared',
+            <Object?>[sql, paramTypes, params],
+            timeout: timeout,
+            token: token,
+          )
+          as ResultSet;
+
+  /// See [MssqlClient.unprepare].
+  Future<void> unprepare(String sql, Map<String, String> paramTypes) =>
+      _call('unprepare', <Object?>[sql, paramTypes]);
+
+  /// See [MssqlClient.executeMulti].
+  Future<List<ResultSet>> executeMulti(
+    String sql, {
+    Map<String, dynamic>? params,
+    Set<int>? include,
+  }) async {
+    final sets = await _call('executeMulti', <Object?>[sql, params, include]);
+    return (sets as List).cast<ResultSet>();
+  }
+
+  /// See [MssqlClient.queryColumnar]. The typed buffers are handed back as
+  /// one message rather than re-encoded.
+  Future<ColumnarResult> queryColumnar(
+    String sql, [
+    Map<String, dynamic>? params,
+  ]) async =>
+      await _call('queryColumnar', <Object?>[sql, params]) as ColumnarResult;
+
+  /// See [MssqlClient.bulkInsert]. Rows of batches already committed by
+  /// `bcp_batch` stay when the load is interrupted.
+  Future<int> bulkInsert(
+    String tableName,
+    List<Map<String, dynamic>> rows, {
+    List<String>? columns,
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'bulkInsert',
+            <Object?>[tableName, rows, columns, batchSize, options],
+            timeout: timeout,
+            token: token,
+          )
+          as int;
+
+  /// See [MssqlClient.bulkInsertColumns]. Typed lists are copied to the
+  /// worker as flat buffers.
+  Future<int> bulkInsertColumns(
+    String tableName,
+    Map<String, Object> columns, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'bulkInsertColumns',
+            <Object?>[tableName, columns, batchSize, options],
+            timeout: timeout,
+            token: token,
+          )
+          as int;
+
+  /// Bulk-load every [RowBatch] of [source] into [tableName] through one
+  /// BCP operation (see [MssqlClient.beginBulk]).
+  ///
+  /// Batches are sent one at a time and [source] is not listened to while a
+  /// batch is in flight, so a producer that respects pause (e.g. a file
+  /// parser driven by `await for`) is held to one batch in memory.
+  /// [onProgress] receives the rows sent and committed so far after every
+  /// batch. On an error from [source] or the server, or when [token] is
+  /// cancelled, the load is ended (rows already sent stay) and
+  /// the error is rethrown. Returns the number of rows copied.
+  Future<int> bulkInsertStream(
+    String tableName,
+    Stream<RowBatch> source, {
+    int batchSize = 1000,
+    BulkOptions? options,
+    void Function(int sent, int committed)? onProgress,
+    CancellationToken? token,
+  }) async {
+    var open = false;
+    try {
+      await for (final batch in source) {
+        if (token != null && token.isCancelled) {
+          throw QueryCancelledException();
+        }
+        if (!open) {
+          await _call('beginBulk', <Object?>[
+            tableName,
+            batch.columns,
+            batchSize,
+            options,
+          ]);
+          open = true;
+        }
+        if (batch.isEmpty) continue;
+        final counts =
+            await _callInterruptible(
+                  'sendBulk',
+                  <Object?>[batch.rows],
+                  token: token,
+                )
+                as List;
+        onProgress?.call(counts[0] as int, counts[1] as int);
+      }
+      if (!open) return 0;
+      open = false;
+      return await _call('endBulk') as int;
+    } catch (_) {
+      if (open) {
+        try {
+          await _call('abortBulk');
+        } catch (e) {
+          MssqlLogger.w('worker | op=abortBulk | error=$e');
+        }
+      }
+      rethrow;
+    }
+  }
+
+  /// See [MssqlClient.bulkUpsert]. An interrupted upsert is rolled back.
+  Future<({int inserted, int updated})> bulkUpsert(
+    String tableName,
+    List<Map<String, dynamic>> rows,
+    List<String> keyColumns, {
+    List<String>? updateColumns,
+    List<String>? columns,
+    int batchSize = 1000,
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'bulkUpsert',
+            <Object?>[
+              tableName,
+              rows,
+              keyColumns,
+              updateColumns,
+              columns,
+              batchSize,
+            ],
+            timeout: timeout,
+            token: token,
+          )
+          as ({int inserted, int updated});
+
+  /// See [MssqlClient.bulkExport].
+  Future<int> bulkExport(
+    String tableOrQuery,
+    String path, {
+    BulkExportFormat format = BulkExportFormat.native,
+    String fieldTerminator = ',',
+    String rowTerminator = '\n',
+    Duration? timeout,
+    CancellationToken? token,
+  }) async =>
+      await _callInterruptible(
+            'bulkExport',
+            <Object?>[
+              tableOrQuery,
+              path,
+              format,
+              fieldTerminator,
+              rowTerminator,
+            ],
+            timeout: timeout,
+            token: token,
+          )
+          as int;
+
+  /// Stream the first row-bearing result set of [sql] in batches of at most
+  /// [batchSize] rows (see [MssqlClient.openCursor]).
+  ///
+  /// Rows are fetched on demand: the next batch is only requested from the
+  /// server once the previous one has been delivered and the subscription is
+  /// not paused, so at most one batch is held in memory regardless of the
+  /// result size. Cancelling the subscription discards the unread rows.
+  /// The session accepts no other commands until the stream is done.
+  Stream<RowBatch> stream(
+    String sql, {
+    Map<String, dynamic>? params,
+    int batchSize = 1000,
+  }) {
+    if (batchSize < 1) {
+      throw ArgumentError.value(batchSize, 'batchSize', 'must be >= 1');
+    }
+    late final StreamController<RowBatch> controller;
+    var columns = const <String>[];
+    var opened = false;
+    var finished = false;
+    var cancelled = false;
+    Future<void>? pumping;
+
+    // Fetch batches until the listener pauses, cancels, or rows run out.
+    Future<void> pump() async {
+      try {
+        if (!opened) {
+          final cols = await _call('openCursor', <Object?>[sql, params]);
+          columns = (cols as List).cast<String>();
+          opened = true;
+          finished = columns.isEmpty;
+        }
+        while (!finished && !cancelled && !controller.isPaused) {
+          final rows =
+              await _call('fetchCursor', <Object?>[batchSize]) as List?;
+          if (rows == null || rows.length < batchSize) finished = true;
+          if (rows != null && rows.isNotEmpty && !cancelled) {
+            controller.add(RowBatch(columns, rows.cast<List<Object?>>()));
+          }
+        }
+        if (finished && !cancelled) controller.close();
+      } catch (e, st) {
+        finished = true;
+        if (!cancelled) {
+          controller.addError(e, st);
+          controller.close();
+        }
+      }
+    }
+
+    void start() {
+      pumping ??= pump().whenComplete(() {
+        pumping = null;
+        // A resume may have arrived while the last round trip was ending.
+        if (!finished && !cancelled && !controller.isPaused) start();
+      });
+    }
+
+    controller = StreamController<RowBatch>(
+      onListen: start,
+      onResume: start,
+      onCancel: () async {
+        cancelled = true;
+        // Let an in-flight round trip land before discarding the rest, so
+        // the session is free again once cancel() completes.
+        await pumping;
+        if (opened && !finished) {
+          finished = true;
+          await _call('closeCursor');
+        }
+      },
+    );
+    return controller.stream;
+  }
+
+  /// See [MssqlClient.close]. The worker stays alive and can [connect] again.
+  Future<void> close() async {
+    try {
+      await _call('close');
+    } finally {
+      _connected = false;
+    }
+  }
+
+  /// Close the session (if any) and shut the worker isolate down.
+  ///
+  /// Idempotent. Pending commands complete before the shutdown is processed.
+  Future<void> dispose() async {
+    if (_disposed) return;
+    try {
+      await _call('shutdown');
+    } catch (e) {
+      MssqlLogger.w('worker | op=dispose | error=$e');
+      _isolate?.kill(priority: Isolate.immediate);
+    } finally {
+      _disposed = true;
+      _connected = false;
+      _inline = null;
+      _commands = null;
+      _isolate = null;
+      _closePorts();
+    }
+  }
+
+  void _closePorts() {
+    _replies?.close();
+    _exitPort?.close();
+    _replies = null;
+    _exitPort = null;
+  }
+}
+
+// Decode a reply payload produced by [_encodeReply].
+Object? _decodeReply(Object? payload) {
+  if (payload is TransferableTypedData) {
+    return utf8.decode(payload.materialize().asUint8List());
+  }
+  return payload;
+}
+
+// Strings (JSON payloads) travel as UTF-8 bytes in a TransferableTypedData.
+// fromList copies the encoded bytes once into the transferable buffer; that
+// buffer then moves to the receiving isolate without another copy, and
+// materialize() on the other side hands it over without copying again.
+Object? _encodeReply(Object? value) {
+  if (value is String) {
+    return TransferableTypedData.fromList(<TypedData>[utf8.encode(value)]);
+  }
+  return value;
+}
+
+Object _rebuildError(String kind, String message) {
+  switch (kind) {
+    case 'sql':
+      return SQLException(message);
+    case 'state':
+      return StateError(message);
+    case 'argument':
+      return ArgumentError(message);
+    case 'cancelled':
+      return QueryCancelledException(message);
+    case 'timeout':
+      return TimeoutException(message);
+    default:
+      return SQLException(message);
+  }
+}
+
+List<Object?> _errorTuple(Object e, StackTrace st) {
+  if (e is QueryCancelledException) {
+    return <Object?>['cancelled', e.message, st.toString()];
+  }
+  if (e is TimeoutException) {
+    return <Object?>['timeout', e.message ?? '', st.toString()];
+  }
+  if (e is SQLException) return <Object?>['sql', e.message, st.toString()];
+  if (e is StateError) return <Object?>['state', e.message, st.toString()];
+  if (e is ArgumentError) {
+    return <Object?>['argument', '${e.message}', st.toString()];
+  }
+  return <Object?>['error', e.toString(), st.toString()];
+}
+
+/// Dispatches worker commands onto a single [MssqlClient], one at a time.
+///
+/// Shared by both execution modes: the worker isolate feeds it from its
+/// command port, and inline mode calls [run] directly.
+class _WorkerHost {
+  final MssqlClient client;
+  Future<void> _tail = Future<void>.value();
+
+  _WorkerHost(this.client);
+
+  /// Queue [op] behind any command still running and return its result.
+  Future<Object?> run(String op, List<Object?> args) {
+    final result = _tail.then((_) => _handle(op, args));
+    _tail = result.then<void>((_) {}, onError: (_) {});
+    return result;
+  }
+
+  Future<Object?> _handle(String op, List<Object?> args) async {
+    switch (op) {
+      case 'initialize':
+        client.initialize();
+        return null;
+      case 'connect':
+        return client.connect(
+          loginTimeoutSeconds: args[0] as int,
+          database: args[1] as String?,
+          packetSize: args[2] as int?,
+        );
+      case 'packetSize':
+        return client.packetSize;
+      case 'interruptible':
+        return client.interruptible(
+          Pointer<MssqlInterrupt>.fromAddress(args[0] as int),
+          args[1] as int,
+          () => _handle(args[2] as String, args[3] as List<Object?>),
+        );
+      case 'execute':
+        return client.execute(args[0] as String);
+      case 'executeParams':
+        return client.executeParams(
+          args[0] as String,
+          (args[1] as Map).cast<String, dynamic>(),
+        );
+      case 'bulkInsert':
+        return client.bulkInsert(
+          args[0] as String,
+          (args[1] as List)
+              .map((r) => (r as Map).cast<String, dynamic>())
+              .toList(growable: false),
+          columns: (args[2] as List?)?.cast<String>(),
+          batchSize: args[3] as int,
+          options: args[4] as BulkOptions?,
+        );
+      case 'bulkInsertColumns':
+        return client.bulkInsertColumns(
+          args[0] as String,
+          (args[1] as Map).cast<String, Object>(),
+          batchSize: args[2] as int,
+          options: args[3] as BulkOptions?,
+        );
+      case 'bulkUpsert':
+        return client.bulkUpsert(
+          args[0] as String,
+          (args[1] as List)
+              .map((r) => (r as Map).cast<String, dynamic>())
+              .toList(growable: false),
+          (args[2] as List).cast<String>(),
+          updateColumns: (args[3] as List?)?.cast<String>(),
+          columns: (args[4] as List?)?.cast<String>(),
+          batchSize: args[5] as int,
+        );
+      case 'bulkExport':
+        return client.bulkExport(
+          args[0] as String,
+          args[1] as String,
+          format: args[2] as BulkExportFormat,
+          fieldTerminator: args[3] as String,
+          rowTerminator: args[4] as String,
+        );
+      case 'beginBulk':
+        return client.beginBulk(
+          args[0] as String,
+          (args[1] as List).cast<String>(),
+          batchSize: args[2] as int,
+          options: args[3] as BulkOptions?,
+        );
+      case 'sendBulk':
+        return client.sendBulk((args[0] as List).cast<List<Object?>>());
+      case 'endBulk':
+        return client.endBulk();
+      case 'abortBulk':
+        return client.abortBulk();
+      case 'query':
+        return client.query(args[0] as String);
+      case 'queryParams':
+        return client.queryParams(
+          args[0] as String,
+          (args[1] as Map).cast<String, dynamic>(),
+        );
+      case 'executeBatch':
+        return client.executeBatch(
+          args[0] as String,
+          (args[1] as List)
+              .map((r) => (r as Map).cast<String, dynamic>())
+              .toList(growable: false),
+          chunk: args[2] as int,
+        );
+      case 'prepare':
+        return client.prepare(
+          args[0] as String,
+          (args[1] as Map).cast<String, String>(),
+        );
+      case 'executePrepared':
+        return client.executePrepared(
+          args[0] as String,
+          (args[1] as Map).cast<String, String>(),
+          (args[2] as Map).cast<String, dynamic>(),
+        );
+      case 'unprepare':
+        return client.unprepare(
+          args[0] as String,
+          (args[1] as Map).cast<String, String>(),
+        );
+      case 'executeMulti':
+        return client.executeMulti(
+          args[0] as String,
+          params: (args[1] as Map?)?.cast<String, dynamic>(),
+          include: (args[2] as Set?)?.cast<int>(),
+        );
+      case 'queryColumnar':
+        return client.queryColumnar(
+          args[0] as String,
+          (args[1] as Map?)?.cast<String, dynamic>(),
+        );
+      case 'openCursor':
+        return client.openCursor(
+          args[0] as String,
+          (args[1] as Map?)?.cast<String, dynamic>(),
+        );
+      case 'fetchCursor':
+        return client.fetchCursor(args[0] as int);
+      case 'closeCursor':
+        return client.closeCursor();
+      case 'close':
+      case 'shutdown':
+        await client.close();
+        return null;
+      default:
+        throw StateError('Unknown worker command: $op');
+    }
+  }
+}
+
+// Worker isolate entry point.
+//
+// init = [SendPort replies, server, username, password, mssqlLog, nativeLog,
+//         statementCacheSize, dbLibPath (String?, the library the spawning
+//         isolate opened), dbinitDone (bool, dbinit already ran)]
+void _workerMain(List<Object?> init) {
+  final replies = init[0] as SendPort;
+  MssqlLogger.enabled = init[4] as bool;
+  NativeLogger.enabled = init[5] as bool;
+  DBLib.adopt(path: init[7] as String?, initialized: init[8] as bool);
+  final host = _WorkerHost(
+    MssqlClient(
+      server: init[1] as String,
+      username: init[2] as String,
+      password: init[3] as String,
+      statementCacheSize: init[6] as int,
+    ),
+  );
+  final commands = ReceivePort('mssql-worker-commands');
+  replies.send(commands.sendPort);
+
+  commands.listen((msg) {
+    final m = msg as List<Object?>;
+    final id = m[0] as int;
+    final op = m[1] as String;
+    final args = m[2] as List<Object?>;
+    host.run(op, args).then(
+      (v) {
+        replies.send(<Object?>[id, true, _encodeReply(v)]);
+        // Closing the last open port lets the isolate exit on its own.
+        if (op == 'shutdown') commands.close();
+      },
+      onError: (Object e, StackTrace st) {
+        replies.send(<Object?>[id, false, _errorTuple(e, st)]);
+        if (op == 'shutdown') commands.close();
+      },
+    );
+  });
+}
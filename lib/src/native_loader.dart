@@ -6,11 +6,49 @@ import 'package:ffi/ffi.dart';
 import 'native_logger.dart';
 
 class NativeLoader {
+  static DynamicLibrary? _dbLib;
+  static String? _dbLibPath;
+
+  /// DB-Lib for this isolate, opened once and then reused.
+  ///
+  /// The first call searches the platform's candidate locations (or opens
+  /// the path given to [rememberDBLibPath]); later calls return the same
+  /// library without searching again.
   static DynamicLibrary loadDBLib() {
+    final cached = _dbLib;
+    if (cached != null) return cached;
+    final known = _dbLibPath;
+    if (known != null) {
+      try {
+        return _dbLib = DynamicLibrary.open(known);
+      } catch (e) {
+        NativeLogger.w('loadDBLib: remembered $known failed -> $e');
+      }
+    }
+    return _dbLib = _searchDBLib();
+  }
+
+  /// Where [loadDBLib] found DB-Lib, or null before it has or when the
+  /// library is linked into the process (iOS).
+  static String? get dbLibPath => _dbLibPath;
+
+  /// Let [loadDBLib] open [path] directly instead of searching, e.g. in a
+  /// worker isolate whose parent already located the library.
+  static void rememberDBLibPath(String? path) {
+    if (path != null && _dbLib == null) _dbLibPath = path;
+  }
+
+  static DynamicLibrary _openDBLib(String path) {
+    final lib = DynamicLibrary.open(path);
+    _dbLibPath = path;
+    return lib;
+  }
+
+  static DynamicLibrary _searchDBLib() {
     NativeLogger.i('loadDBLib: platform=${Platform.operatingSystem}');
     if (Platform.isAndroid) {
       NativeLogger.i('Android: opening libsybdb.so');
-      return DynamicLibrary.open('libsybdb.so');
+      return _openDBLib('libsybdb.so');
     } else if (Platform.isIOS) {
       // iOS links the XCFramework statically via CocoaPods; use process.
       NativeLogger.i('iOS: using DynamicLibrary.process()');
@@ -22,7 +60,7 @@ class NativeLoader {
       for (final name in ['libsybdb.dylib', 'libsybdb.5.dylib']) {
         try {
           NativeLogger.i('macOS: trying $name');
-          final lib = DynamicLibrary.open(name);
+          final lib = _openDBLib(name);
           NativeLogger.i('macOS: opened $name');
           return lib;
         } catch (e) {
@@ -53,7 +91,7 @@ class NativeLoader {
           final p = '$dir/$name';
           try {
             NativeLogger.i('Linux[DB]: trying $p');
-            final lib = DynamicLibrary.open(p);
+            final lib = _openDBLib(p);
             NativeLogger.i('Linux[DB]: opened $p');
             return lib;
           } catch (e) {
@@ -70,7 +108,7 @@ class NativeLoader {
       ]) {
         try {
           NativeLogger.i('Linux[DB]: trying $name');
-          final lib = DynamicLibrary.open(name);
+          final lib = _openDBLib(name);
           NativeLogger.i('Linux[DB]: opened $name');
           return lib;
         } catch (e) {
@@ -85,7 +123,7 @@ class NativeLoader {
       _setDefaultDllDirectories();
       try {
         NativeLogger.i('Windows[DB]: trying sybdb.dll by name');
-        return DynamicLibrary.open('sybdb.dll');
+        return _openDBLib('sybdb.dll');
       } catch (e) {
         lastErr = e;
         tried.add('sybdb.dll');
@@ -143,7 +181,7 @@ class NativeLoader {
               NativeLogger.w('Windows[DB]: open ct.dll failed -> $e');
             }
           }
-          return DynamicLibrary.open(db);
+          return _openDBLib(db);
         } catch (e) {
           NativeLogger.w('Windows[DB]: failed -> $e');
           lastErr = e; /* try next dir */
@@ -283,6 +321,63 @@ class NativeLoader {
     throw UnsupportedError('Could not load FreeTDS CT-Lib for this platform.');
   }
 
+  /// Load the optional mssql_native helper (built from native/).
+  ///
+  /// Returns null instead of throwing when the helper is not shipped for the
+  /// current platform; callers then use their pure-Dart fallbacks.
+  static DynamicLibrary? loadMssqlNative() {
+    NativeLogger.i('loadMssqlNative: platform=${Platform.operatingSystem}');
+    final names = <String>[];
+    if (Platform.isAndroid) {
+      names.add('libmssql_native.so');
+    } else if (Platform.isIOS) {
+      // Statically linked into the app when present.
+      final lib = DynamicLibrary.process();
+      return lib.providesSymbol('mssql_native_abi_version') ? lib : null;
+    } else if (Platform.isMacOS) {
+      for (final d in _candidateDirs('macos/Libraries/lib')) {
+        names.add('$d/libmssql_native.dylib');
+      }
+      names.add('libmssql_native.dylib');
+    } else if (Platform.isLinux) {
+      for (final d in [
+        ..._candidateDirs('linux/Libraries/lib'),
+        ..._candidateDirs('linux/Libraries'),
+      ]) {
+        names.add('$d/libmssql_native.so');
+      }
+      names.add('libmssql_native.so');
+    } else if (Platform.isWindows) {
+      names.add('mssql_native.dll');
+      for (final d in _candidateDirs('windows\\Libraries\\bin', sep: '\\')) {
+        names.add('$d\\mssql_native.dll');
+      }
+    }
+    for (final name in names) {
+      try {
+        final lib = DynamicLibrary.open(name);
+        NativeLogger.i('loadMssqlNative: opened $name');
+        return lib;
+      } catch (e) {
+        NativeLogger.w('loadMssqlNative: failed $name -> $e');
+      }
+    }
+    return null;
+  }
+
+  // Repo-root (script parent) and cwd relative candidates for [rel].
+  static List<String> _candidateDirs(String rel, {String sep = '/'}) {
+    final dirs = <String>[];
+    try {
+      final root = File.fromUri(Platform.script).parent.parent.path;
+      dirs.add('$root$sep$rel');
+    } catch (_) {}
+    try {
+      dirs.add('${Directory.current.path}$sep$rel');
+    } catch (_) {}
+    return dirs;
+  }
+
 
   static void _setDllDirectory(String dir) {
     try {
@@ -0,0 +1,66 @@
+import 'dart:async';
+
+import 'cancellation_token.dart';
+import 'mssql_worker.dart';
+import 'result_set.dart';
+
+/// Resolves the session a [PreparedStatement] runs on. With `reconnect` the
+/// owner may open a new session; without it, it returns the live session or
+/// null.
+typedef PreparedStatementSession =
+    Future<MssqlWorker?> Function(bool reconnect);
+
+/// A statement prepared once on the server (`sp_prepare`) and then executed
+/// by handle (`sp_execute`), so repeated calls send only the values.
+///
+/// Obtained from `MssqlConnection.prepare` or `MssqlPooledConnection.prepare`.
+/// The handle belongs to the session's statement cache: if the session
+/// reconnects or the handle is evicted, the next [execute] prepares the
+/// statement again in the same round trip.
+class PreparedStatement {
+  final String sql;
+
+  /// Declared parameters, name -> SQL type, in parameter order.
+  final Map<String, String> paramTypes;
+
+  final PreparedStatementSession _session;
+  bool _closed = false;
+
+  PreparedStatement(
+    this.sql,
+    Map<String, String> paramTypes,
+    this._session,
+  ) : paramTypes = Map<String, String>.unmodifiable(paramTypes);
+
+  bool get isClosed => _closed;
+
+  /// Run the statement with [params] bound by name (with or without `@`).
+  /// Every declared parameter needs a value; see `MssqlConnection.getData`
+  /// for [timeout] and [cancelToken].
+  Future<ResultSet> execute(
+    Map<String, dynamic> params, {
+    Duration? timeout,
+    CancellationToken? cancelToken,
+  }) async {
+    if (_closed) throw StateError('Prepared statement already closed');
+    final worker = await _session(true);
+    if (worker == null) throw StateError('Not connected. Call connect() first.');
+    return worker.executePrepared(
+      sql,
+      paramTypes,
+      params,
+      timeout: timeout,
+      token: cancelToken,
+    );
+  }
+
+  /// Release the server-side handle (`sp_unprepare`). Idempotent; a handle
+  /// whose session is already gone needs no release.
+  Future<void> close() async {
+    if (_closed) return;
+    _closed = true;
+    final worker = await _session(false);
+    if (worker == null || !worker.isConnected) return;
+    await worker.unprepare(sql, paramTypes);
+  }
+}
@@ -0,0 +1,73 @@
+import 'dart:convert';
+
+/// A decoded query result: column metadata, typed row values and the number
+/// of affected rows.
+///
+/// Values keep their Dart types (`int`, `double`, `bool`, `String`, ...) as
+/// decoded from DB-Lib; binary values are Base64 strings and date/time values
+/// ISO-8601 strings, exactly as in the JSON payload of `getData`. The JSON
+/// text is only produced when [toJsonString] is called.
+class ResultSet {
+  /// Column names of the first row-bearing result set.
+  final List<String> columns;
+
+  /// DB-Lib type code (`dbcoltype`) of each column.
+  final List<int> columnTypes;
+
+  /// Row values, each in [columns] order.
+  final List<List<Object?>> rows;
+
+  /// Rows affected across all result sets (sum of `dbcount`).
+  final int affected;
+
+  /// Set when DB-Lib reported a failure while reading results.
+  final String? error;
+
+  ResultSet({
+    required this.columns,
+    required this.columnTypes,
+    required this.rows,
+    required this.affected,
+    this.error,
+  });
+
+  String? _json;
+
+  int get length => rows.length;
+
+  bool get isEmpty => rows.isEmpty;
+
+  /// The row at [index] keyed by column name.
+  Map<String, dynamic> rowAt(int index) {
+    final values = rows[index];
+    final row = <String, dynamic>{};
+    for (var i = 0; i < columns.length; i++) {
+      row[columns[i]] = values[i];
+    }
+    return row;
+  }
+
+  /// All rows keyed by column name.
+  List<Map<String, dynamic>> get rowMaps =>
+      List<Map<String, dynamic>>.generate(length, rowAt, growable: false);
+
+  /// The `{columns, rows, affected, error?}` shape returned by `getData`
+  /// (also used by `jsonEncode`).
+  Map<String, dynamic> toJson() {
+    final result = <String, dynamic>{
+      'columns': columns,
+      'rows': rowMaps,
+      'affected': affected,
+    };
+    if (error != null) result['error'] = error;
+    return result;
+  }
+
+  /// [toJson] encoded as a JSON string; computed on first use and cached.
+  String toJsonString() => _json ??= jsonEncode(toJson());
+
+  @override
+  String toString() =>
+      'ResultSet(columns: $columns, rows: ${rows.length}, affected: $affected'
+      '${error != null ? ', error: $error' : ''})';
+}
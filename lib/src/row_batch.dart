@@ -0,0 +1,30 @@
+/// A chunk of rows from a streamed query.
+///
+/// Rows are stored positionally (values in [columns] order) so a batch does
+/// not repeat column names per row; use [rowAt] or [toMaps] for the keyed
+/// shape returned by `getData`.
+class RowBatch {
+  /// Column names of the streamed result set.
+  final List<String> columns;
+
+  /// Row values, each in [columns] order.
+  final List<List<Object?>> rows;
+
+  const RowBatch(this.columns, this.rows);
+
+  int get length => rows.length;
+
+  bool get isEmpty => rows.isEmpty;
+
+  /// The row at [index] keyed by column name.
+  Map<String, dynamic> rowAt(int index) {
+    final values = rows[index];
+    return <String, dynamic>{
+      for (var i = 0; i < columns.length; i++) columns[i]: values[i],
+    };
+  }
+
+  /// All rows keyed by column name.
+  List<Map<String, dynamic>> toMaps() =>
+      List<Map<String, dynamic>>.generate(length, rowAt, growable: false);
+}
@@ -0,0 +1,270 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'ffi/freetds_bindings.dart';
+import 'ffi/mssql_native_bindings.dart';
+
+/// Iterates the rows of the current DB-Lib result set.
+///
+/// When the mssql_native helper is available, rows are drained in batches by
+/// `mssql_fetch_rows` and cells are read from its packed arena, so a batch of
+/// rows costs one FFI call. Otherwise fixed-width columns (integers, floats,
+/// BIT, DATETIME) are bound with `dbbind`/`dbnullbind` into one reusable
+/// native row buffer that DB-Lib fills during `dbnextrow`; only the remaining
+/// columns cost a `dbdata` plus `dbdatlen` call per cell.
+///
+/// Every reader exposes a cell exactly as `dbdata`/`dbdatlen` would, so the
+/// decoders in freetds_bindings.dart work unchanged on any of them.
+///
+/// Pointers returned by [data] are valid until the next call to [next].
+/// Always [dispose] the reader, even after an error.
+abstract class RowReader {
+  /// Rows per `mssql_fetch_rows` call.
+  static const int batchRows = 1024;
+
+  /// Soft cap on arena bytes per call (large text values may exceed it).
+  static const int batchBytes = 4 << 20;
+
+  factory RowReader(DBLib db, Pointer<DBPROCESS> dbproc) {
+    final native = MssqlNative.instance;
+    if (native != null) {
+      return _ArenaRowReader(native, dbproc, db.dbnumcols(dbproc));
+    }
+    return _BoundRowReader.tryCreate(db, dbproc) ??
+        _DbLibRowReader(db, dbproc);
+  }
+
+  /// Advance to the next regular row (compute rows are skipped).
+  ///
+  /// Returns [REG_ROW] when positioned on a row, otherwise the terminal
+  /// `dbnextrow` code ([NO_MORE_ROWS], [FAIL], ...).
+  int next();
+
+  /// Pointer to the value of 1-based column [col], or `nullptr` for NULL.
+  Pointer<Uint8> data(int col);
+
+  /// Byte length of the value of 1-based column [col] (0 for NULL).
+  int length(int col);
+
+  void dispose();
+}
+
+class _DbLibRowReader implements RowReader {
+  final DBLib _db;
+  final Pointer<DBPROCESS> _dbproc;
+
+  _DbLibRowReader(this._db, this._dbproc);
+
+  @override
+  int next() {
+    while (true) {
+      final rc = _db.dbnextrow(_dbproc);
+      // Positive codes are compute rows (COMPUTE BY); they have another shape.
+      if (rc > 0) continue;
+      return rc;
+    }
+  }
+
+  @override
+  Pointer<Uint8> data(int col) => _db.dbdata(_dbproc, col);
+
+  @override
+  int length(int col) => _db.dbdatlen(_dbproc, col);
+
+  @override
+  void dispose() {}
+}
+
+class _BoundRowReader extends _DbLibRowReader {
+  final Pointer<Uint8> _row;
+  final Pointer<Int32> _nulls;
+  // Byte offset of each column in [_row], or -1 when it is read via dbdata.
+  final Int32List _offsets;
+  final Int32List _widths;
+
+  _BoundRowReader._(
+    DBLib db,
+    Pointer<DBPROCESS> dbproc,
+    this._row,
+    this._nulls,
+    this._offsets,
+    this._widths,
+  ) : super(db, dbproc);
+
+  /// Bind the fixed-width columns of the current result set, or return null
+  /// when there are none.
+  static _BoundRowReader? tryCreate(DBLib db, Pointer<DBPROCESS> dbproc) {
+    final ncols = db.dbnumcols(dbproc);
+    final offsets = Int32List(ncols)..fillRange(0, ncols, -1);
+    final widths = Int32List(ncols);
+    final bindTypes = Int32List(ncols);
+    var size = 0;
+    for (var c = 0; c < ncols; c++) {
+      final col = c + 1;
+      final bind = _bindFor(
+        db.dbcoltype(dbproc, col),
+        db.dbcollen(dbproc, col),
+      );
+      if (bind == null) continue;
+      bindTypes[c] = bind.$1;
+      widths[c] = bind.$2;
+      offsets[c] = size;
+      size += 8; // every bound width fits in one 8-byte aligned slot
+    }
+    if (size == 0) return null;
+
+    final row = calloc<Uint8>(size);
+    final nulls = calloc<Int32>(ncols);
+    for (var c = 0; c < ncols; c++) {
+      if (offsets[c] < 0) continue;
+      final col = c + 1;
+      final ok =
+          db.dbbind(dbproc, col, bindTypes[c], 0, row + offsets[c]) ==
+              SUCCEED &&
+          db.dbnullbind(dbproc, col, nulls + c) == SUCCEED;
+      // Fall back to dbdata for a column DB-Lib refuses to bind.
+      if (!ok) offsets[c] = -1;
+    }
+    return _BoundRowReader._(db, dbproc, row, nulls, offsets, widths);
+  }
+
+  // dbbind type and width matching the column's own storage, so bound bytes
+  // are identical to what dbdata would return for it.
+  static (int, int)? _bindFor(int type, int collen) {
+    switch (type) {
+      case SYBINT1:
+        return (TINYBIND, 1);
+      case SYBINT2:
+        return (SMALLBIND, 2);
+      case SYBINT4:
+        return (INTBIND, 4);
+      case SYBINT8:
+        return (BIGINTBIND, 8);
+      case SYBINTN:
+        switch (collen) {
+          case 1:
+            return (TINYBIND, 1);
+          case 2:
+            return (SMALLBIND, 2);
+          case 4:
+            return (INTBIND, 4);
+          case 8:
+            return (BIGINTBIND, 8);
+        }
+        return null;
+      case SYBREAL:
+        return (REALBIND, 4);
+      case SYBFLT8:
+        return (FLT8BIND, 8);
+      case SYBFLTN:
+        if (collen == 4) return (REALBIND, 4);
+        if (collen == 8) return (FLT8BIND, 8);
+        return null;
+      case SYBBIT:
+      case SYBBITN:
+        return (BITBIND, 1);
+      case SYBDATETIME:
+        return (DATETIMEBIND, 8);
+      case SYBDATETIMN:
+        return collen == 8 ? (DATETIMEBIND, 8) : null;
+      default:
+        return null;
+    }
+  }
+
+  @override
+  Pointer<Uint8> data(int col) {
+    final off = _offsets[col - 1];
+    if (off < 0) return super.data(col);
+    return _nulls[col - 1] == -1 ? nullptr : _row + off;
+  }
+
+  @override
+  int length(int col) {
+    final off = _offsets[col - 1];
+    if (off < 0) return super.length(col);
+    return _nulls[col - 1] == -1 ? 0 : _widths[col - 1];
+  }
+
+  @override
+  void dispose() {
+    calloc.free(_row);
+    calloc.free(_nulls);
+  }
+}
+
+class _ArenaRowReader implements RowReader {
+  final MssqlNative _native;
+  final Pointer<DBPROCESS> _dbproc;
+  final Pointer<MssqlArena> _arena;
+  final Int32List _offsets;
+  final Int32List _lengths;
+
+  Pointer<Uint8> _base = nullptr;
+  ByteData _view = ByteData(0);
+  int _pos = 0;
+  int _remaining = 0;
+  int _status = REG_ROW;
+  bool _drained = false;
+
+  _ArenaRowReader(this._native, this._dbproc, int ncols)
+    : _arena = _native.mssql_arena_new(64 * 1024),
+      _offsets = Int32List(ncols),
+      _lengths = Int32List(ncols) {
+    if (_arena == nullptr) {
+      throw StateError('mssql_native: could not allocate a row arena');
+    }
+  }
+
+  @override
+  int next() {
+    if (_remaining == 0) {
+      if (_drained) return _status;
+      final n = _native.mssql_fetch_rows(
+        _dbproc.cast(),
+        RowReader.batchRows,
+        RowReader.batchBytes,
+        _arena,
+      );
+      final a = _arena.ref;
+      _status = a.status;
+      _drained =
+          n < 0 ||
+          _status == NO_MORE_ROWS ||
+          _status == FAIL ||
+          _status == BUF_FULL;
+      if (n <= 0) {
+        _drained = true;
+        return n < 0 ? FAIL : _status;
+      }
+      _remaining = n;
+      _pos = 0;
+      _base = a.data;
+      _view = ByteData.sublistView(_base.asTypedList(a.size));
+    }
+    for (var c = 0; c < _offsets.length; c++) {
+      final len = _view.getInt32(_pos, Endian.host);
+      _pos += 4;
+      _offsets[c] = _pos;
+      _lengths[c] = len;
+      if (len > 0) _pos += len;
+    }
+    _remaining--;
+    return REG_ROW;
+  }
+
+  @override
+  Pointer<Uint8> data(int col) =>
+      _lengths[col - 1] < 0 ? nullptr : _base + _offsets[col - 1];
+
+  @override
+  int length(int col) {
+    final len = _lengths[col - 1];
+    return len < 0 ? 0 : len;
+  }
+
+  @override
+  void dispose() => _native.mssql_arena_free(_arena);
+}
@@ -8,4 +8,39 @@ class SQLException implements Exception {
   String toString() {
     return 'SQLException: $message';
   }
-}
\ No newline at end of file
+}
+
+// Thrown when a call is abandoned through its CancellationToken.
+class QueryCancelledException extends SQLException {
+  QueryCancelledException([super.message = 'Query was cancelled']);
+
+  @override
+  String toString() {
+    return 'QueryCancelledException: $message';
+  }
+}
+
+// Thrown by MssqlPool.parallelBulkInsert when at least one shard failed.
+// Shards that succeeded (and batches of failed shards already committed)
+// stay loaded.
+class ParallelBulkInsertException extends SQLException {
+  // Rows copied per shard; null for shards that failed.
+  final List<int?> shardCounts;
+
+  // Error of each failed shard, keyed by shard index.
+  final Map<int, Object> errors;
+
+  ParallelBulkInsertException(this.shardCounts, this.errors)
+    : super(
+        '${errors.length} of ${shardCounts.length} bulk insert shards failed: '
+        '${errors.values.first}',
+      );
+
+  // Rows copied by the shards that succeeded.
+  int get inserted => shardCounts.fold<int>(0, (a, n) => a + (n ?? 0));
+
+  @override
+  String toString() {
+    return 'ParallelBulkInsertException: $message';
+  }
+}
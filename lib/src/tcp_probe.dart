@@ -0,0 +1,75 @@
+import 'dart:io';
+
+import 'native_logger.dart';
+
+/// TCP reachability check behind `connect(failFast: true)`.
+///
+/// A probe is one TCP handshake to `host:port` that is closed straight
+/// away. Results are kept per endpoint for [ttl] in the calling isolate,
+/// and concurrent checks of the same endpoint share one attempt, so a pool
+/// opening several sessions or a burst of reconnects costs at most one
+/// extra handshake per endpoint and TTL.
+class TcpProbe {
+  TcpProbe._();
+
+  /// How long a settled result (reachable or not) is reused.
+  static const Duration ttl = Duration(seconds: 5);
+
+  static final Map<String, _ProbeEntry> _entries = <String, _ProbeEntry>{};
+
+  /// Split `host:port` into its parts; null when [server] has no numeric
+  /// port (e.g. a named instance or a freetds.conf alias).
+  static (String, int)? splitHostPort(String server) {
+    final idx = server.lastIndexOf(':');
+    if (idx <= 0 || idx == server.length - 1) return null;
+    final port = int.tryParse(server.substring(idx + 1));
+    if (port == null) return null;
+    return (server.substring(0, idx), port);
+  }
+
+  /// Whether `host:port` accepts TCP connections within [timeout] (null
+  /// leaves it to the operating system). Never throws.
+  static Future<bool> reachable(String host, int port, {Duration? timeout}) {
+    final key = '$host:$port';
+    final hit = _entries[key];
+    if (hit != null) {
+      final settled = hit.settledAt;
+      if (settled == null || DateTime.now().difference(settled) < ttl) {
+        MssqlLogger.i(
+          'probe | host=$host | port=$port | cached=true'
+          '${settled == null ? ' | in-flight=true' : ''}',
+        );
+        return hit.result;
+      }
+    }
+    final entry = _ProbeEntry(_connect(host, port, timeout));
+    _entries[key] = entry;
+    entry.result.then((_) => entry.settledAt = DateTime.now());
+    return entry.result;
+  }
+
+  /// Forget every cached result.
+  static void clear() => _entries.clear();
+
+  static Future<bool> _connect(String host, int port, Duration? timeout) async {
+    try {
+      final sock = await Socket.connect(host, port, timeout: timeout);
+      // Immediately dispose; this is a reachability probe only.
+      sock.destroy();
+      MssqlLogger.i('probe | host=$host | port=$port | reachable=true');
+      return true;
+    } catch (e) {
+      MssqlLogger.w(
+        'probe | host=$host | port=$port | reachable=false | error=$e',
+      );
+      return false;
+    }
+  }
+}
+
+class _ProbeEntry {
+  final Future<bool> result;
+  DateTime? settledAt;
+
+  _ProbeEntry(this.result);
+}
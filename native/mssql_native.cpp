@@ -0,0 +1,266 @@
+// mssql_native — native helpers for the Dart DB-Lib client.
+//
+// See mssql_native.h for the exported C ABI.
+
+#include "mssql_native.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <sybfront.h>
+#include <sybdb.h>
+
+namespace {
+
+// ---- Error / message store ---------------------------------------------------
+//
+// DB-Lib handlers are process-global and run on whichever thread is inside a
+// DB-Lib call, i.e. on any worker isolate. Dart FFI callbacks are bound to the
+// isolate that created them, so the handlers live here and Dart polls the
+// store after a failed call.
+
+class MessageStore {
+ public:
+  void Put(const void* dbproc, std::string msg) {
+    std::lock_guard<std::mutex> lock(mu_);
+    map_[Key(dbproc)] = std::move(msg);
+  }
+
+  int32_t Take(const void* dbproc, char* buf, int32_t cap) {
+    std::string msg;
+    {
+      std::lock_guard<std::mutex> lock(mu_);
+      auto it = map_.find(Key(dbproc));
+      if (it == map_.end()) return -1;
+      msg = std::move(it->second);
+      map_.erase(it);
+    }
+    if (buf != nullptr && cap > 0) {
+      const size_t n = msg.size() < static_cast<size_t>(cap - 1)
+                           ? msg.size()
+                           : static_cast<size_t>(cap - 1);
+      std::memcpy(buf, msg.data(), n);
+      buf[n] = '\0';
+    }
+    return static_cast<int32_t>(msg.size());
+  }
+
+ private:
+  static uintptr_t Key(const void* dbproc) {
+    return reinterpret_cast<uintptr_t>(dbproc);
+  }
+
+  std::mutex mu_;
+  std::unordered_map<uintptr_t, std::string> map_;
+};
+
+MessageStore& Errors() {
+  static MessageStore store;
+  return store;
+}
+
+MessageStore& Messages() {
+  static MessageStore store;
+  return store;
+}
+
+// Same text shape as the Dart fallback handlers in freetds_bindings.dart.
+int ErrHandler(DBPROCESS* dbproc, int severity, int dberr, int oserr,
+               char* dberrstr, char* oserrstr) {
+  char head[96];
+  std::snprintf(head, sizeof(head), "[severity=%d dberr=%d oserr=%d] ",
+                severity, dberr, oserr);
+  std::string msg(head);
+  if (dberrstr != nullptr) msg += dberrstr;
+  if (oserrstr != nullptr) {
+    msg += " | ";
+    msg += oserrstr;
+  }
+  Errors().Put(dbproc, std::move(msg));
+  // INT_CANCEL on a timeout closes the socket; INT_TIMEOUT only sends an
+  // attention, so the session survives an interrupted statement.
+  return dberr == SYBETIME ? INT_TIMEOUT : INT_CANCEL;
+}
+
+int MsgHandler(DBPROCESS* dbproc, DBINT msgno, int msgstate, int severity,
+               char* msgtext, char* /*srvname*/, char* /*proc*/, int line) {
+  char head[96];
+  std::snprintf(head, sizeof(head), "[msgno=%d state=%d severity=%d line=%d] ",
+                static_cast<int>(msgno), msgstate, severity, line);
+  std::string msg(head);
+  if (msgtext != nullptr) msg += msgtext;
+  Messages().Put(dbproc, std::move(msg));
+  return 0;
+}
+
+std::once_flag g_handlers_once;
+
+// ---- Interrupts --------------------------------------------------------------
+//
+// The slot is written by the Dart isolate that owns the call while the worker
+// thread is blocked inside DB-Lib, so every access goes through volatile.
+
+int64_t NowMs() {
+  using namespace std::chrono;
+  return duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+      .count();
+}
+
+volatile mssql_interrupt* SlotOf(void* dbproc) {
+  return reinterpret_cast<volatile mssql_interrupt*>(
+      dbgetuserdata(static_cast<DBPROCESS*>(dbproc)));
+}
+
+int ChkIntr(void* dbproc) {
+  volatile mssql_interrupt* slot = SlotOf(dbproc);
+  // After the attention has gone out, keep waiting for its acknowledgement.
+  if (slot == nullptr || slot->fired != 0) return FALSE;
+  if (slot->request == MSSQL_INTERRUPT_NONE && slot->deadline_ms > 0 &&
+      NowMs() >= slot->deadline_ms) {
+    slot->request = MSSQL_INTERRUPT_TIMED_OUT;
+  }
+  return slot->request != MSSQL_INTERRUPT_NONE ? TRUE : FALSE;
+}
+
+int HndlIntr(void* dbproc) {
+  volatile mssql_interrupt* slot = SlotOf(dbproc);
+  if (slot != nullptr) slot->fired = 1;
+  return INT_CANCEL;
+}
+
+// ---- Arena -------------------------------------------------------------------
+
+bool Reserve(mssql_arena* arena, int64_t extra) {
+  const int64_t need = arena->size + extra;
+  if (need <= arena->capacity) return true;
+  int64_t cap = arena->capacity > 0 ? arena->capacity : 4096;
+  while (cap < need) cap *= 2;
+  void* grown = std::realloc(arena->data, static_cast<size_t>(cap));
+  if (grown == nullptr) return false;
+  arena->data = static_cast<uint8_t*>(grown);
+  arena->capacity = cap;
+  return true;
+}
+
+void PutInt32(mssql_arena* arena, int32_t v) {
+  std::memcpy(arena->data + arena->size, &v, sizeof(v));
+  arena->size += sizeof(v);
+}
+
+}  // namespace
+
+extern "C" {
+
+int32_t mssql_native_abi_version(void) { return MSSQL_NATIVE_ABI_VERSION; }
+
+void mssql_install_handlers(void) {
+  std::call_once(g_handlers_once, [] {
+    dberrhandle(ErrHandler);
+    dbmsghandle(MsgHandler);
+  });
+}
+
+int32_t mssql_take_last_error(void* dbproc, char* buf, int32_t cap) {
+  return Errors().Take(dbproc, buf, cap);
+}
+
+int32_t mssql_take_last_message(void* dbproc, char* buf, int32_t cap) {
+  return Messages().Take(dbproc, buf, cap);
+}
+
+void mssql_arm_interrupt(void* dbproc, mssql_interrupt* slot) {
+  auto* proc = static_cast<DBPROCESS*>(dbproc);
+  dbsetuserdata(proc, reinterpret_cast<BYTE*>(slot));
+  if (slot != nullptr) {
+    dbsetinterrupt(proc, ChkIntr, HndlIntr);
+  } else {
+    dbsetinterrupt(proc, nullptr, nullptr);
+  }
+}
+
+mssql_arena* mssql_arena_new(int64_t initial_capacity) {
+  auto* arena =
+      static_cast<mssql_arena*>(std::calloc(1, sizeof(mssql_arena)));
+  if (arena == nullptr) return nullptr;
+  if (initial_capacity > 0 && !Reserve(arena, initial_capacity)) {
+    std::free(arena);
+    return nullptr;
+  }
+  return arena;
+}
+
+void mssql_arena_free(mssql_arena* arena) {
+  if (arena == nullptr) return;
+  std::free(arena->data);
+  std::free(arena);
+}
+
+int32_t mssql_fetch_rows(void* dbproc, int32_t max_rows, int64_t max_bytes,
+                         mssql_arena* arena) {
+  auto* proc = static_cast<DBPROCESS*>(dbproc);
+  arena->size = 0;
+  arena->rows = 0;
+  arena->status = REG_ROW;
+  const int ncols = dbnumcols(proc);
+  while (arena->rows < max_rows && arena->size < max_bytes) {
+    const STATUS rc = dbnextrow(proc);
+    arena->status = rc;
+    if (rc == NO_MORE_ROWS || rc == FAIL || rc == BUF_FULL) break;
+    if (rc != REG_ROW) continue;  // compute row
+    for (int col = 1; col <= ncols; ++col) {
+      const BYTE* data = dbdata(proc, col);
+      const int32_t len = data == nullptr ? -1 : dbdatlen(proc, col);
+      const int64_t bytes = len > 0 ? len : 0;
+      if (!Reserve(arena, static_cast<int64_t>(sizeof(int32_t)) + bytes)) {
+        arena->status = FAIL;
+        return -1;
+      }
+      PutInt32(arena, len);
+      if (bytes > 0) {
+        std::memcpy(arena->data + arena->size, data, static_cast<size_t>(bytes));
+        arena->size += bytes;
+      }
+    }
+    ++arena->rows;
+  }
+  return arena->rows;
+}
+
+int32_t mssql_bcp_send_chunk(void* dbproc, const mssql_bcp_column* columns,
+                             int32_t ncols, int64_t first_row, int32_t rows,
+                             int32_t* failed_row) {
+  auto* proc = static_cast<DBPROCESS*>(dbproc);
+  *failed_row = -1;
+  for (int32_t i = 0; i < rows; ++i) {
+    const int64_t row = first_row + i;
+    for (int32_t c = 0; c < ncols; ++c) {
+      const mssql_bcp_column& col = columns[c];
+      const int table_col = c + 1;
+      if (col.nulls != nullptr && col.nulls[row] != 0) {
+        bcp_collen(proc, -1, table_col);
+        bcp_colptr(proc, nullptr, table_col);
+      } else if (col.width > 0) {
+        bcp_collen(proc, col.width, table_col);
+        bcp_colptr(proc, const_cast<BYTE*>(col.data + row * col.width),
+                   table_col);
+      } else {
+        const int64_t start = col.offsets[row];
+        bcp_collen(proc, static_cast<DBINT>(col.offsets[row + 1] - start),
+                   table_col);
+        bcp_colptr(proc, const_cast<BYTE*>(col.data + start), table_col);
+      }
+    }
+    if (bcp_sendrow(proc) != SUCCEED) {
+      *failed_row = i;
+      return i;
+    }
+  }
+  return rows;
+}
+
+}  // extern "C"
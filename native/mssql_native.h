@@ -0,0 +1,129 @@
+// mssql_native — C ABI consumed by lib/src/ffi/mssql_native_bindings.dart.
+//
+// All functions are thread-safe and may be called from any Dart isolate.
+
+#ifndef MSSQL_NATIVE_H
+#define MSSQL_NATIVE_H
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(MSSQL_NATIVE_BUILD)
+#    define MSSQL_NATIVE_API __declspec(dllexport)
+#  else
+#    define MSSQL_NATIVE_API __declspec(dllimport)
+#  endif
+#else
+#  define MSSQL_NATIVE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bumped whenever an exported signature changes; checked by the Dart loader.
+#define MSSQL_NATIVE_ABI_VERSION 4
+
+MSSQL_NATIVE_API int32_t mssql_native_abi_version(void);
+
+// ---- Error / message handlers --------------------------------------------
+//
+// Installs native dberrhandle/dbmsghandle callbacks once per process. The
+// latest error and server message are stored per DBPROCESS (key 0 for
+// library-level events) and retrieved with the take functions below.
+
+MSSQL_NATIVE_API void mssql_install_handlers(void);
+
+// Copy and clear the last error/message recorded for [dbproc].
+// Returns the full UTF-8 byte length (possibly larger than [cap], in which
+// case the copy is truncated), or -1 when nothing was recorded.
+MSSQL_NATIVE_API int32_t mssql_take_last_error(void* dbproc, char* buf,
+                                               int32_t cap);
+MSSQL_NATIVE_API int32_t mssql_take_last_message(void* dbproc, char* buf,
+                                                 int32_t cap);
+
+// ---- Batched row fetch ---------------------------------------------------
+//
+// Drains rows of the current result set into a packed buffer in one call,
+// replacing one dbnextrow plus two dbdata/dbdatlen FFI crossings per cell.
+//
+// Layout of arena->data after a fetch, row-major, for each cell of each row:
+//   int32_t len   (host order; -1 for NULL, i.e. dbdata() returned NULL)
+//   uint8_t bytes[len]   (raw DB-Lib representation, as returned by dbdata)
+// Cells are not padded; readers must not assume alignment.
+
+typedef struct mssql_arena {
+  uint8_t* data;     // owned by the arena, grown on demand
+  int64_t size;      // bytes written by the last fetch
+  int64_t capacity;  // allocated bytes
+  int32_t rows;      // rows written by the last fetch
+  int32_t status;    // last dbnextrow result (REG_ROW, NO_MORE_ROWS, FAIL...)
+} mssql_arena;
+
+MSSQL_NATIVE_API mssql_arena* mssql_arena_new(int64_t initial_capacity);
+MSSQL_NATIVE_API void mssql_arena_free(mssql_arena* arena);
+
+// Replace the arena contents with up to [max_rows] regular rows, stopping
+// early once [max_bytes] have been written or dbnextrow stops returning
+// rows. Compute rows are skipped. Returns the number of rows written, or -1
+// if the arena could not grow (arena->status is then FAIL).
+MSSQL_NATIVE_API int32_t mssql_fetch_rows(void* dbproc, int32_t max_rows,
+                                          int64_t max_bytes,
+                                          mssql_arena* arena);
+
+// ---- Interrupts ----------------------------------------------------------
+//
+// Lets a blocked dbsqlexec/dbresults/dbnextrow be abandoned from another
+// thread. DB-Lib polls the armed slot about once a second while it waits on
+// the server; once [request] is non-zero (written by any thread) or
+// [deadline_ms] has passed, an attention is sent and the pending call fails
+// after the server acknowledges it, leaving the DBPROCESS reusable once
+// dbcancel has flushed it.
+
+#define MSSQL_INTERRUPT_NONE 0
+#define MSSQL_INTERRUPT_CANCELLED 1
+#define MSSQL_INTERRUPT_TIMED_OUT 2
+
+typedef struct mssql_interrupt {
+  int32_t request;      // MSSQL_INTERRUPT_*; set by the owner or on timeout
+  int32_t fired;        // 1 once the attention has been sent
+  int64_t deadline_ms;  // Unix epoch milliseconds; 0 for no deadline
+} mssql_interrupt;
+
+// Arm [slot] for [dbproc] (stored as its dbsetuserdata pointer), or disarm
+// with NULL. The slot must outlive the armed period.
+MSSQL_NATIVE_API void mssql_arm_interrupt(void* dbproc, mssql_interrupt* slot);
+
+// ---- Bulk copy ----------------------------------------------------------
+//
+// Sends a range of rows held column by column in native memory, replacing
+// bcp_collen + bcp_colptr per cell and bcp_sendrow per row from Dart with one
+// FFI call per chunk. Every column must already be bcp_bind'ed with
+// [host_type]; row r of a column is:
+//   fixed-width (width > 0):  data[r * width .. (r + 1) * width)
+//   variable (width == 0):    data[offsets[r] .. offsets[r + 1])
+// and is NULL when [nulls] is set and nulls[r] != 0.
+
+typedef struct mssql_bcp_column {
+  int32_t host_type;       // SYB* type passed to bcp_bind
+  int32_t width;           // bytes per row, or 0 for variable-length
+  const uint8_t* data;     // column values
+  const int64_t* offsets;  // rows + 1 byte offsets; NULL for fixed-width
+  const uint8_t* nulls;    // per-row NULL flags; NULL when none
+} mssql_bcp_column;
+
+// bcp_sendrow rows [first_row, first_row + rows) of [columns]. Returns the
+// number of rows sent and stores in [*failed_row] the index (relative to
+// [first_row]) of the row whose bcp_sendrow failed, or -1 when all were
+// sent. Batching (bcp_batch) and bcp_done stay with the caller.
+MSSQL_NATIVE_API int32_t mssql_bcp_send_chunk(void* dbproc,
+                                              const mssql_bcp_column* columns,
+                                              int32_t ncols, int64_t first_row,
+                                              int32_t rows,
+                                              int32_t* failed_row);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // MSSQL_NATIVE_H
@@ -0,0 +1,197 @@
+import 'dart:typed_data';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('bulkInsertColumns', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    setUp(() async {
+      await harness.recreateTable('''
+CREATE TABLE dbo.ColLoad (
+  id INT NOT NULL,
+  big BIGINT NULL,
+  price FLOAT NULL,
+  small SMALLINT NULL,
+  tiny TINYINT NULL,
+  flag BIT NULL,
+  name NVARCHAR(50) NULL,
+  blob VARBINARY(16) NULL
+)''');
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('loads typed columns without per-row maps', () async {
+      const n = 5000;
+      final ids = Int32List(n);
+      final prices = Float64List(n);
+      final small = Int16List(n);
+      final tiny = Uint8List(n);
+      for (var i = 0; i < n; i++) {
+        ids[i] = i;
+        prices[i] = i * 0.5;
+        small[i] = i % 1000;
+        tiny[i] = i % 256;
+      }
+      final inserted = await harness.client.bulkInsertColumns(
+        'dbo.ColLoad',
+        {'id': ids, 'price': prices, 'small': small, 'tiny': tiny},
+        batchSize: 1000,
+      );
+      expect(inserted, n);
+
+      final rows = parseRows(
+        await harness.query(
+          'SELECT COUNT(*) AS n, SUM(CAST(id AS BIGINT)) AS ids, SUM(price) AS p, '
+          'MAX(small) AS s, MAX(tiny) AS t FROM dbo.ColLoad',
+        ),
+      );
+      expect(rows.single['n'], n);
+      expect(rows.single['ids'], n * (n - 1) ~/ 2);
+      expect(rows.single['p'], closeTo(n * (n - 1) / 4, 1e-6));
+      expect(rows.single['s'], 999);
+      expect(rows.single['t'], 255);
+    });
+
+    test('nullable lists, text and binary round-trip', () async {
+      final inserted = await harness.client.bulkInsertColumns('dbo.ColLoad', {
+        'id': Int32List.fromList([1, 2, 3]),
+        'big': <int?>[1 << 40, null, -5],
+        'flag': <bool?>[true, null, false],
+        'name': <String?>['Ärger', null, ''],
+        'blob': <Uint8List?>[
+          Uint8List.fromList([1, 2, 3]),
+          null,
+          Uint8List(0),
+        ],
+      });
+      expect(inserted, 3);
+
+      final rs = await harness.client.getResultSet(
+        'SELECT id, big, flag, name, DATALENGTH(blob) AS bl FROM dbo.ColLoad ORDER BY id',
+      );
+      expect(rs.rows[0], [1, 1 << 40, true, 'Ärger', 3]);
+      expect(rs.rows[1], [2, null, null, null, null]);
+      expect(rs.rows[2][1], -5);
+      expect(rs.rows[2][2], false);
+    });
+
+    test('bulkInsert crosses chunk and batch boundaries', () async {
+      // More rows than one native chunk, with batches that do not divide it.
+      final rows = List.generate(
+        5000,
+        (i) => <String, dynamic>{
+          'id': i,
+          'name': i.isEven ? 'row $i' : null,
+          'price': i / 4,
+        },
+      );
+      final inserted = await harness.client.bulkInsert(
+        'dbo.ColLoad',
+        rows,
+        batchSize: 700,
+      );
+      expect(inserted, rows.length);
+
+      final out = parseRows(
+        await harness.query(
+          'SELECT COUNT(*) AS n, COUNT(name) AS named, MAX(id) AS hi FROM dbo.ColLoad',
+        ),
+      );
+      expect(out.single['n'], 5000);
+      expect(out.single['named'], 2500);
+      expect(out.single['hi'], 4999);
+    });
+
+    test('temp tables load through multi-row INSERTs', () async {
+      await harness.execute(
+        'CREATE TABLE #ColStage (id INT NOT NULL, big BIGINT NULL, name NVARCHAR(50) NULL)',
+      );
+      try {
+        // 3 columns per row: 699 rows per statement, the last one partial.
+        final rows = List.generate(
+          2500,
+          (i) => <String, dynamic>{
+            'id': i,
+            'big': i == 0 ? null : (i == 2499 ? 1 << 40 : i),
+            'name': "n'$i",
+          },
+        );
+        final inserted = await harness.client.bulkInsert('#ColStage', rows);
+        expect(inserted, 2500);
+
+        final out = parseRows(
+          await harness.query(
+            'SELECT COUNT(*) AS n, COUNT(big) AS bigs, MAX(big) AS hi, '
+            "SUM(CASE WHEN name = N'n''' + CAST(id AS NVARCHAR(10)) THEN 1 ELSE 0 END) AS named "
+            'FROM #ColStage',
+          ),
+        );
+        expect(out.single['n'], 2500);
+        expect(out.single['bigs'], 2499);
+        expect(out.single['hi'], 1 << 40);
+        expect(out.single['named'], 2500);
+      } finally {
+        await harness.execute('DROP TABLE #ColStage');
+      }
+    });
+
+    test('temp table loads past the parameter limit are rejected', () async {
+      final row = <String, dynamic>{for (var i = 0; i < 2098; i++) 'c$i': i};
+      await expectLater(
+        harness.client.bulkInsert('#TooWide', [row]),
+        throwsArgumentError,
+      );
+    });
+
+    test('temp table load failures carry the server message', () async {
+      await harness.execute('CREATE TABLE #ColStrict (id INT NOT NULL)');
+      try {
+        await expectLater(
+          harness.client.bulkInsert('#ColStrict', [
+            <String, dynamic>{'id': 1},
+            <String, dynamic>{'id': null},
+          ]),
+          throwsA(
+            isA<SQLException>().having(
+              (e) => e.message,
+              'message',
+              contains('NULL'),
+            ),
+          ),
+        );
+      } finally {
+        await harness.execute('DROP TABLE #ColStrict');
+      }
+    });
+
+    test('columns of different lengths are rejected', () async {
+      await expectLater(
+        harness.client.bulkInsertColumns('dbo.ColLoad', {
+          'id': Int32List(3),
+          'price': Float64List(2),
+        }),
+        throwsArgumentError,
+      );
+    });
+
+    test('empty columns insert nothing', () async {
+      expect(
+        await harness.client.bulkInsertColumns('dbo.ColLoad', {
+          'id': Int32List(0),
+        }),
+        0,
+      );
+    });
+  });
+}
@@ -0,0 +1,71 @@
+import 'dart:io';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('bulkExport', () {
+    final harness = TempDbHarness();
+    late Directory dir;
+
+    setUpAll(() async {
+      await harness.init();
+      await harness.recreateTable(
+        'CREATE TABLE dbo.ExportItems (id INT NOT NULL, name NVARCHAR(50) NULL, price FLOAT NULL)',
+      );
+      await harness.client.bulkInsert(
+        'dbo.ExportItems',
+        List.generate(
+          2000,
+          (i) => <String, dynamic>{'id': i, 'name': 'item $i', 'price': i / 2},
+        ),
+      );
+      dir = await Directory.systemTemp.createTemp('mssql_export');
+    });
+
+    tearDownAll(() async {
+      await dir.delete(recursive: true);
+      await harness.dispose();
+    });
+
+    test('writes a table as delimited text', () async {
+      final path = '${dir.path}/items.txt';
+      final n = await harness.client.bulkExport(
+        'dbo.ExportItems',
+        path,
+        format: BulkExportFormat.character,
+      );
+      expect(n, 2000);
+      final lines = await File(path).readAsLines();
+      expect(lines, hasLength(2000));
+      final row = lines.firstWhere((l) => l.startsWith('7,'));
+      expect(row.split(',').take(2), ['7', 'item 7']);
+      expect(double.parse(row.split(',')[2]), 3.5);
+    });
+
+    test('writes query rows in native format', () async {
+      final path = '${dir.path}/items.bcp';
+      final n = await harness.client.bulkExport(
+        'SELECT id, price FROM dbo.ExportItems WHERE id < 500',
+        path,
+      );
+      expect(n, 500);
+      // Native INT and FLOAT values are 4 and 8 bytes, plus length prefixes
+      // on nullable columns.
+      expect(await File(path).length(), greaterThanOrEqualTo(500 * 12));
+    });
+
+    test('an unknown table fails with SQLException', () async {
+      await expectLater(
+        harness.client.bulkExport(
+          'dbo.NoSuchTable',
+          '${dir.path}/none.txt',
+          format: BulkExportFormat.character,
+        ),
+        throwsA(isA<SQLException>()),
+      );
+    });
+  });
+}
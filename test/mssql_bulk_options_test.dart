@@ -0,0 +1,109 @@
+import 'dart:typed_data';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  test('hints are composed in a fixed order with quoted ORDER columns', () {
+    expect(const BulkOptions().hints, isEmpty);
+    expect(
+      const BulkOptions(
+        tableLock: true,
+        order: ['id', 'ts desc', 'odd]name'],
+        checkConstraints: true,
+        keepNulls: true,
+        rowsPerBatch: 5000,
+      ).hints,
+      'TABLOCK, ORDER([id] ASC, [ts] DESC, [odd]]name] ASC), '
+      'CHECK_CONSTRAINTS, KEEP_NULLS, ROWS_PER_BATCH = 5000',
+    );
+  });
+
+  group('bulkInsert with BulkOptions', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    setUp(() async {
+      await harness.recreateTable('''
+CREATE TABLE dbo.OptLoad (
+  id INT IDENTITY(1,1) NOT NULL PRIMARY KEY CLUSTERED,
+  qty INT NULL CONSTRAINT DF_OptLoad_qty DEFAULT 7,
+  CONSTRAINT CK_OptLoad_qty CHECK (qty IS NULL OR qty >= 0)
+)''');
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('TABLOCK and ORDER load a clustered index in key order', () async {
+      final ids = Int32List.fromList(List.generate(3000, (i) => i + 1));
+      final inserted = await harness.client.bulkInsertColumns(
+        'dbo.OptLoad',
+        {'id': ids, 'qty': Int32List(3000)},
+        options: const BulkOptions(
+          tableLock: true,
+          order: ['id'],
+          keepIdentity: true,
+        ),
+      );
+      expect(inserted, 3000);
+      final rows = parseRows(
+        await harness.query('SELECT COUNT(*) AS n, MAX(id) AS hi FROM dbo.OptLoad'),
+      );
+      expect(rows.single['n'], 3000);
+      expect(rows.single['hi'], 3000);
+    });
+
+    test('keepIdentity and keepNulls preserve the supplied values', () async {
+      final rows = [
+        {'id': 100, 'qty': null},
+        {'id': 200, 'qty': 3},
+      ];
+      await harness.client.bulkInsert(
+        'dbo.OptLoad',
+        rows,
+        options: const BulkOptions(keepIdentity: true, keepNulls: true),
+      );
+      final out = await harness.client.getResultSet(
+        'SELECT id, qty FROM dbo.OptLoad ORDER BY id',
+      );
+      expect(out.rows, [
+        [100, null],
+        [200, 3],
+      ]);
+    });
+
+    test('checkConstraints rejects rows the CHECK forbids', () async {
+      // Without the hint the server skips the CHECK constraint.
+      expect(
+        await harness.client.bulkInsert(
+          'dbo.OptLoad',
+          [
+            {'id': 1, 'qty': -1},
+          ],
+          options: const BulkOptions(keepIdentity: true),
+        ),
+        1,
+      );
+      await expectLater(
+        harness.client.bulkInsert(
+          'dbo.OptLoad',
+          [
+            {'id': 2, 'qty': -1},
+          ],
+          options: const BulkOptions(
+            keepIdentity: true,
+            checkConstraints: true,
+          ),
+        ),
+        throwsA(isA<SQLException>()),
+      );
+    });
+  });
+}
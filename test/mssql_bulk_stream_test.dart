@@ -0,0 +1,107 @@
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('bulkInsertStream', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    setUp(() async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.StreamLoad (id BIGINT NOT NULL, name NVARCHAR(50) NULL, price FLOAT NULL)',
+      );
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    Stream<RowBatch> batches(int count, int size) async* {
+      const columns = ['id', 'name', 'price'];
+      for (var b = 0; b < count; b++) {
+        yield RowBatch(columns, [
+          for (var i = b * size; i < (b + 1) * size; i++)
+            <Object?>[i, i.isEven ? 'row $i' : null, i / 2],
+        ]);
+      }
+    }
+
+    test('loads every batch through one operation with progress', () async {
+      final progress = <List<int>>[];
+      final inserted = await harness.client.bulkInsertStream(
+        'dbo.StreamLoad',
+        batches(8, 500),
+        batchSize: 1200,
+        onProgress: (sent, committed) => progress.add([sent, committed]),
+      );
+      expect(inserted, 4000);
+      expect(progress.map((p) => p[0]), [
+        500,
+        1000,
+        1500,
+        2000,
+        2500,
+        3000,
+        3500,
+        4000,
+      ]);
+      // bcp_batch commits at 1200, 2400 and 3600 rows.
+      expect(progress.last[1], 3600);
+
+      final rows = parseRows(
+        await harness.query(
+          'SELECT COUNT(*) AS n, COUNT(name) AS named, MAX(id) AS hi FROM dbo.StreamLoad',
+        ),
+      );
+      expect(rows.single['n'], 4000);
+      expect(rows.single['named'], 2000);
+      expect(rows.single['hi'], 3999);
+    });
+
+    test('integers wider than the first batch are not truncated', () async {
+      final inserted = await harness.client.bulkInsertStream(
+        'dbo.StreamLoad',
+        Stream.fromIterable([
+          const RowBatch(['id'], [<Object?>[1]]),
+          const RowBatch(['id'], [<Object?>[1 << 40]]),
+        ]),
+      );
+      expect(inserted, 2);
+      final rows = parseRows(
+        await harness.query('SELECT MAX(id) AS hi FROM dbo.StreamLoad'),
+      );
+      expect(rows.single['hi'], 1 << 40);
+    });
+
+    test('a failing source aborts the load and frees the session', () async {
+      Stream<RowBatch> failing() async* {
+        yield* batches(2, 100);
+        throw StateError('source failed');
+      }
+
+      await expectLater(
+        harness.client.bulkInsertStream('dbo.StreamLoad', failing()),
+        throwsStateError,
+      );
+      final rows = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.StreamLoad'),
+      );
+      expect(rows.single['n'], 0);
+    });
+
+    test('an empty stream inserts nothing', () async {
+      expect(
+        await harness.client.bulkInsertStream(
+          'dbo.StreamLoad',
+          const Stream.empty(),
+        ),
+        0,
+      );
+    });
+  });
+}
@@ -0,0 +1,146 @@
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('bulkUpsert', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    setUp(() async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.UpsertItems (id INT NOT NULL PRIMARY KEY, name NVARCHAR(50) NULL, qty INT NULL)',
+      );
+      await harness.execute(
+        "INSERT INTO dbo.UpsertItems VALUES (1, N'one', 1), (2, N'two', 2)",
+      );
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('updates matched keys and inserts the rest', () async {
+      final rows = List.generate(
+        5000,
+        (i) => <String, dynamic>{'id': i + 1, 'name': 'item ${i + 1}', 'qty': i},
+      );
+      final result = await harness.client.bulkUpsert(
+        'dbo.UpsertItems',
+        rows,
+        ['id'],
+      );
+      expect(result.updated, 2);
+      expect(result.inserted, 4998);
+
+      final out = parseRows(
+        await harness.query(
+          "SELECT COUNT(*) AS n, MAX(CASE WHEN id = 2 THEN name END) AS two FROM dbo.UpsertItems",
+        ),
+      );
+      expect(out.single['n'], 5000);
+      expect(out.single['two'], 'item 2');
+      // No staging table is left behind.
+      final stages = parseRows(
+        await harness.query(
+          "SELECT COUNT(*) AS n FROM sys.tables WHERE name LIKE N'[_][_]upsert[_]%'",
+        ),
+      );
+      expect(stages.single['n'], 0);
+    });
+
+    test('updateColumns limits what matched rows change', () async {
+      final result = await harness.client.bulkUpsert(
+        'dbo.UpsertItems',
+        [
+          {'id': 1, 'name': 'uno', 'qty': 10},
+          {'id': 3, 'name': 'tres', 'qty': 30},
+        ],
+        ['id'],
+        updateColumns: ['qty'],
+      );
+      expect(result, (inserted: 1, updated: 1));
+      final rs = await harness.client.getResultSet(
+        'SELECT id, name, qty FROM dbo.UpsertItems ORDER BY id',
+      );
+      expect(rs.rows, [
+        [1, 'one', 10],
+        [2, 'two', 2],
+        [3, 'tres', 30],
+      ]);
+    });
+
+    test('a failing MERGE rolls everything back', () async {
+      // Duplicate keys make MERGE update the same row twice.
+      await expectLater(
+        harness.client.bulkUpsert('dbo.UpsertItems', [
+          {'id': 1, 'name': 'a', 'qty': 1},
+          {'id': 1, 'name': 'b', 'qty': 2},
+          {'id': 9, 'name': 'c', 'qty': 3},
+        ], ['id']),
+        throwsA(isA<SQLException>()),
+      );
+      final out = parseRows(
+        await harness.query(
+          'SELECT COUNT(*) AS n, @@TRANCOUNT AS tc FROM dbo.UpsertItems',
+        ),
+      );
+      expect(out.single['n'], 2);
+      expect(out.single['tc'], 0);
+    });
+
+    test('a missing target table leaves no transaction open', () async {
+      await expectLater(
+        harness.client.bulkUpsert('dbo.UpsertMissing', [
+          {'id': 1, 'name': 'a', 'qty': 1},
+        ], ['id']),
+        throwsA(isA<SQLException>()),
+      );
+      final out = parseRows(await harness.query('SELECT @@TRANCOUNT AS tc'));
+      expect(out.single['tc'], 0);
+    });
+
+    test('a failure inside a caller transaction keeps it open', () async {
+      await harness.client.beginTransaction();
+      try {
+        await harness.execute(
+          "INSERT INTO dbo.UpsertItems VALUES (7, N'seven', 7)",
+        );
+        await expectLater(
+          harness.client.bulkUpsert('dbo.UpsertItems', [
+            {'id': 1, 'name': 'a', 'qty': 1},
+            {'id': 1, 'name': 'b', 'qty': 2},
+          ], ['id']),
+          throwsA(isA<SQLException>()),
+        );
+        // The caller's insert is still there, uncommitted.
+        final during = parseRows(
+          await harness.query(
+            'SELECT COUNT(*) AS n, @@TRANCOUNT AS tc FROM dbo.UpsertItems',
+          ),
+        );
+        expect(during.single['n'], 3);
+        expect(during.single['tc'], 1);
+      } finally {
+        await harness.client.rollback();
+      }
+      final after = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.UpsertItems'),
+      );
+      expect(after.single['n'], 2);
+    });
+
+    test('key columns must be among the loaded columns', () async {
+      await expectLater(
+        harness.client.bulkUpsert('dbo.UpsertItems', [
+          {'id': 1},
+        ], ['code']),
+        throwsArgumentError,
+      );
+    });
+  });
+}
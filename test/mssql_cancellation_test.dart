@@ -0,0 +1,116 @@
+import 'dart:async';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('timeouts and cancellation', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+      await harness.recreateTable(
+        'CREATE TABLE dbo.CancelBulk (id INT NOT NULL, name NVARCHAR(20) NULL)',
+      );
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('timeout abandons a long statement and the session recovers', () async {
+      final sw = Stopwatch()..start();
+      await expectLater(
+        harness.client.getData(
+          "WAITFOR DELAY '00:00:30'",
+          timeout: const Duration(seconds: 1),
+        ),
+        throwsA(isA<TimeoutException>()),
+      );
+      expect(sw.elapsed, lessThan(const Duration(seconds: 10)));
+
+      final rows = parseRows(await harness.query('SELECT 1 AS one'));
+      expect(rows.single['one'], 1);
+    });
+
+    test('fast statements finish within their timeout', () async {
+      final rows = parseRows(
+        await harness.client.getDataWithParams(
+          'SELECT @v AS v',
+          {'v': 7},
+          timeout: const Duration(seconds: 5),
+        ),
+      );
+      expect(rows.single['v'], 7);
+    });
+
+    test('cancel token interrupts a running statement', () async {
+      final token = CancellationToken();
+      final sw = Stopwatch()..start();
+      final pending = harness.client.getData(
+        "WAITFOR DELAY '00:00:30'",
+        cancelToken: token,
+      );
+      Timer(const Duration(milliseconds: 500), token.cancel);
+      await expectLater(pending, throwsA(isA<QueryCancelledException>()));
+      expect(sw.elapsed, lessThan(const Duration(seconds: 10)));
+
+      final rs = await harness.client.getResultSet('SELECT 2 AS two');
+      expect(rs.rows.single.single, 2);
+    });
+
+    test('an already cancelled token fails fast without running', () async {
+      final token = CancellationToken()..cancel();
+      await expectLater(
+        harness.client.writeData(
+          "INSERT INTO dbo.CancelBulk VALUES (-1, N'never')",
+          cancelToken: token,
+        ),
+        throwsA(isA<QueryCancelledException>()),
+      );
+      final rows = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.CancelBulk'),
+      );
+      expect(rows.single['n'], 0);
+    });
+
+    test('bulkInsert accepts a timeout', () async {
+      final rows = List.generate(
+        500,
+        (i) => <String, dynamic>{'id': i, 'name': 'r$i'},
+      );
+      final n = await harness.client.bulkInsert(
+        'dbo.CancelBulk',
+        rows,
+        timeout: const Duration(seconds: 30),
+      );
+      expect(n, 500);
+    });
+
+    test('cancelling a large bulkInsert leaves the session usable', () async {
+      await harness.execute('TRUNCATE TABLE dbo.CancelBulk');
+      final rows = List.generate(
+        500000,
+        (i) => <String, dynamic>{'id': i, 'name': 'row $i'},
+      );
+      final token = CancellationToken();
+      final pending = harness.client.bulkInsert(
+        'dbo.CancelBulk',
+        rows,
+        batchSize: 100000,
+        cancelToken: token,
+      );
+      Timer(const Duration(milliseconds: 200), token.cancel);
+      await expectLater(pending, throwsA(isA<QueryCancelledException>()));
+
+      final one = parseRows(await harness.query('SELECT 1 AS one'));
+      expect(one.single['one'], 1);
+      final n = await harness.client.bulkInsert('dbo.CancelBulk', [
+        <String, dynamic>{'id': -2, 'name': 'after'},
+      ]);
+      expect(n, 1);
+    });
+  });
+}
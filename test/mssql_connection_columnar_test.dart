@@ -0,0 +1,81 @@
+import 'dart:typed_data';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('Columnar queries', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('maps SQL types to typed buffers', () async {
+      final res = await harness.client.queryColumnar('''
+SELECT CAST(1 AS TINYINT) AS t, CAST(-2 AS SMALLINT) AS s, CAST(3 AS INT) AS i,
+       CAST(9000000000 AS BIGINT) AS b, CAST(1.5 AS FLOAT) AS f,
+       CAST(2.25 AS DECIMAL(10,2)) AS d, CAST(1 AS BIT) AS bit,
+       N'héllo' AS n, 'abc' AS v, 0x0102FF AS bin
+''');
+      expect(res.rowCount, 1);
+      expect(res.columnNames, [
+        't',
+        's',
+        'i',
+        'b',
+        'f',
+        'd',
+        'bit',
+        'n',
+        'v',
+        'bin',
+      ]);
+      expect(res.column('t')!.int32Values[0], 1);
+      expect(res.column('s')!.int32Values[0], -2);
+      expect(res.column('i')!.kind, ColumnKind.int32);
+      expect(res.column('b')!.int64Values[0], 9000000000);
+      expect(res.column('f')!.float64Values[0], 1.5);
+      expect(res.column('d')!.float64Values[0], closeTo(2.25, 1e-9));
+      expect(res.column('bit')![0], isTrue);
+      expect(res.column('n')![0], 'héllo');
+      expect(res.column('v')![0], 'abc');
+      expect(res.column('bin')![0], Uint8List.fromList([1, 2, 255]));
+    });
+
+    test('tracks NULLs and empty strings per row', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.Col (id INT NOT NULL PRIMARY KEY, v INT NULL, s NVARCHAR(10) NULL)',
+      );
+      await harness.execute(
+        "INSERT INTO dbo.Col VALUES (1, 10, N'a'), (2, NULL, NULL), (3, 30, N'')",
+      );
+      final res = await harness.client.queryColumnar(
+        'SELECT v, s FROM dbo.Col WHERE id <= @max ORDER BY id',
+        params: {'max': 3},
+      );
+      final v = res.column('v')!;
+      final s = res.column('s')!;
+      expect(res.rowCount, 3);
+      expect([v.isNull(0), v.isNull(1), v.isNull(2)], [false, true, false]);
+      expect(v.int32Values, [10, 0, 30]);
+      expect([s[0], s[1], s[2]], ['a', null, '']);
+      expect(s.offsets, [0, 1, 1, 1]);
+    });
+
+    test('statements without rows return an empty result', () async {
+      await harness.recreateTable('CREATE TABLE dbo.ColW (id INT)');
+      final res = await harness.client.queryColumnar(
+        'INSERT INTO dbo.ColW VALUES (1), (2)',
+      );
+      expect(res.columns, isEmpty);
+      expect(res.affected, 2);
+    });
+  });
+}
@@ -0,0 +1,58 @@
+import 'dart:async';
+
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('Worker isolate execution', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('caller event loop keeps running during a blocking batch', () async {
+      var ticks = 0;
+      final timer = Timer.periodic(
+        const Duration(milliseconds: 20),
+        (_) => ticks++,
+      );
+      try {
+        final res = await harness.query(
+          "WAITFOR DELAY '00:00:01'; SELECT 42 AS answer",
+        );
+        expect(parseRows(res).first['answer'], 42);
+      } finally {
+        timer.cancel();
+      }
+      // With DB-Lib running inline, the timer could not fire until the batch
+      // returned; on the worker it keeps ticking throughout.
+      expect(ticks, greaterThan(10));
+    });
+
+    test('concurrent calls are serialized on the session', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.Seq (id INT NOT NULL PRIMARY KEY)',
+      );
+      final futures = <Future<String>>[];
+      for (var i = 1; i <= 20; i++) {
+        futures.add(
+          harness.executeParams('INSERT INTO dbo.Seq (id) VALUES (@id)', {
+            'id': i,
+          }),
+        );
+      }
+      final results = await Future.wait(futures);
+      expect(results.map(affectedCount).every((a) => a == 1), isTrue);
+      final rows = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.Seq'),
+      );
+      expect(rows.first['n'], 20);
+    });
+  });
+}
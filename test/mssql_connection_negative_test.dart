@@ -62,6 +62,25 @@ void main() {
       expect(ok, isFalse);
     });
 
+    test('failFast rejects an unreachable port before the login', () async {
+      final conn = MssqlConnection.getInstance();
+      for (var i = 0; i < 2; i++) {
+        // The second attempt reuses the cached probe result.
+        final sw = Stopwatch()..start();
+        final ok = await conn.connect(
+          ip: '192.168.1.10',
+          port: '1',
+          databaseName: 'master',
+          username: 'sa',
+          password: 'eSeal@123',
+          timeoutInSeconds: 2,
+          failFast: true,
+        );
+        expect(ok, isFalse);
+        expect(sw.elapsed, lessThan(const Duration(seconds: 3)));
+      }
+    });
+
     test('connect fails with non-numeric port', () async {
       final conn = MssqlConnection.getInstance();
       final ok = await conn.connect(
@@ -0,0 +1,125 @@
+import 'dart:async';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('Streaming queries', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+      await harness.recreateTable(
+        'CREATE TABLE dbo.StreamRows (id INT NOT NULL PRIMARY KEY, name NVARCHAR(20) NULL)',
+      );
+      await harness.execute('''
+;WITH N AS (SELECT 1 AS i UNION ALL SELECT i + 1 FROM N WHERE i < 2500)
+INSERT INTO dbo.StreamRows (id, name)
+SELECT i, CASE WHEN i % 10 = 0 THEN NULL ELSE CONCAT(N'n', i) END FROM N
+OPTION (MAXRECURSION 0);
+''');
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('delivers every row in bounded batches', () async {
+      var total = 0;
+      var batches = 0;
+      await for (final batch in harness.client.getDataStream(
+        'SELECT id, name FROM dbo.StreamRows ORDER BY id',
+        batchSize: 1000,
+      )) {
+        expect(batch.columns, ['id', 'name']);
+        expect(batch.length, lessThanOrEqualTo(1000));
+        for (final row in batch.rows) {
+          total++;
+          expect(row[0], total);
+          expect(row[1], total % 10 == 0 ? isNull : 'n$total');
+        }
+        batches++;
+      }
+      expect(total, 2500);
+      expect(batches, 3);
+      // The session is usable again once the stream is done.
+      final rows = parseRows(await harness.query('SELECT 1 AS ok'));
+      expect(rows.first['ok'], 1);
+    });
+
+    test('row stream with parameters', () async {
+      final rows = await harness.client
+          .getRowStream(
+            'SELECT id, name FROM dbo.StreamRows WHERE id <= @max ORDER BY id',
+            params: {'max': 5},
+            batchSize: 2,
+          )
+          .toList();
+      expect(rows.map((r) => r['id']).toList(), [1, 2, 3, 4, 5]);
+      expect(rows.first['name'], 'n1');
+    });
+
+    test('cancelling discards unread rows', () async {
+      final first = await harness.client
+          .getDataStream(
+            'SELECT id FROM dbo.StreamRows ORDER BY id',
+            batchSize: 100,
+          )
+          .first;
+      expect(first.length, 100);
+      final rows = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.StreamRows'),
+      );
+      expect(rows.first['n'], 2500);
+    });
+
+    test('pausing stops fetching', () async {
+      final seen = <int>[];
+      final done = Completer<void>();
+      late StreamSubscription<RowBatch> sub;
+      sub = harness.client
+          .getDataStream('SELECT id FROM dbo.StreamRows', batchSize: 500)
+          .listen(
+            (batch) {
+              seen.add(batch.length);
+              if (seen.length == 1) {
+                sub.pause(Future.delayed(const Duration(milliseconds: 200)));
+              }
+            },
+            onDone: done.complete,
+            onError: done.completeError,
+          );
+      await Future.delayed(const Duration(milliseconds: 100));
+      // Nothing beyond the batch in flight arrives while paused.
+      expect(seen.length, lessThanOrEqualTo(2));
+      await done.future;
+      expect(seen.fold<int>(0, (a, b) => a + b), 2500);
+    });
+
+    test('other calls are rejected while a stream is open', () async {
+      final it = StreamIterator(
+        harness.client.getDataStream(
+          'SELECT id FROM dbo.StreamRows',
+          batchSize: 10,
+        ),
+      );
+      expect(await it.moveNext(), isTrue);
+      await expectLater(
+        harness.query('SELECT 1'),
+        throwsA(isA<StateError>()),
+      );
+      await it.cancel();
+      final rows = parseRows(await harness.query('SELECT 2 AS x'));
+      expect(rows.first['x'], 2);
+    });
+
+    test('errors surface as SQLException', () async {
+      await expectLater(
+        harness.client.getDataStream('SELECT * FROM dbo.NoSuchTable').toList(),
+        throwsA(isA<SQLException>()),
+      );
+    });
+  });
+}
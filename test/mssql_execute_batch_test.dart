@@ -0,0 +1,120 @@
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('executeBatch', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    setUp(() async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.BatchItems (id INT NOT NULL PRIMARY KEY, name NVARCHAR(50) NULL)',
+      );
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('inserts every set and reports per-set counts', () async {
+      final sets = List.generate(
+        2500,
+        (i) => <String, dynamic>{'id': i, 'name': "n'$i"},
+      );
+      final counts = await harness.client.executeBatch(
+        'INSERT INTO dbo.BatchItems (id, name) VALUES (@id, @name)',
+        sets,
+        chunk: 1000,
+      );
+      expect(counts, hasLength(2500));
+      expect(counts.every((c) => c == 1), isTrue);
+
+      final rows = parseRows(
+        await harness.query(
+          "SELECT COUNT(*) AS n, MAX(id) AS hi FROM dbo.BatchItems WHERE name LIKE N'n''%'",
+        ),
+      );
+      expect(rows.single['n'], 2500);
+      expect(rows.single['hi'], 2499);
+    });
+
+    test('counts differ per set for updates', () async {
+      await harness.execute(
+        "INSERT INTO dbo.BatchItems VALUES (1, N'a'), (2, N'a'), (3, N'b')",
+      );
+      final counts = await harness.client.executeBatch(
+        'UPDATE dbo.BatchItems SET name = @to WHERE name = @from',
+        [
+          {'from': 'a', 'to': 'x'},
+          {'from': 'b', 'to': 'y'},
+          {'from': 'missing', 'to': 'z'},
+        ],
+      );
+      expect(counts, [2, 1, 0]);
+    });
+
+    test('chunks stay under the parameter limit', () async {
+      // 3 parameters per set: 1000 sets would need 3001 parameters.
+      final sets = List.generate(
+        1000,
+        (i) => <String, dynamic>{'id': i, 'name': 'p$i', 'unused': null},
+      );
+      final counts = await harness.client.executeBatch(
+        'INSERT INTO dbo.BatchItems (id, name) SELECT @id, @name WHERE @unused IS NULL',
+        sets,
+      );
+      expect(counts.fold<int>(0, (a, c) => a + c), 1000);
+    });
+
+    test('a set over the parameter limit is rejected up front', () async {
+      final before = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.BatchItems'),
+      ).single['n'];
+      final wide = <String, dynamic>{
+        'id': -1,
+        for (var i = 0; i < 2100; i++) 'x$i': i,
+      };
+      await expectLater(
+        harness.client.executeBatch(
+          'INSERT INTO dbo.BatchItems (id, name) VALUES (@id, NULL)',
+          [
+            {'id': -2},
+            wide,
+          ],
+        ),
+        throwsA(
+          isA<ArgumentError>().having(
+            (e) => '${e.message}',
+            'message',
+            contains('paramSets[1]'),
+          ),
+        ),
+      );
+      final after = parseRows(
+        await harness.query('SELECT COUNT(*) AS n FROM dbo.BatchItems'),
+      ).single['n'];
+      expect(after, before);
+    });
+
+    test('an empty list sends nothing', () async {
+      expect(
+        await harness.client.executeBatch('SELECT @x', const []),
+        isEmpty,
+      );
+    });
+
+    test('invalid parameter names are rejected', () async {
+      await expectLater(
+        harness.client.executeBatch('SELECT 1', [
+          {"x'; DROP TABLE dbo.BatchItems; --": 1},
+        ]),
+        throwsArgumentError,
+      );
+    });
+  });
+}
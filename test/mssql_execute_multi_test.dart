@@ -0,0 +1,73 @@
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('executeMulti', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+      await harness.recreateTable(
+        'CREATE TABLE dbo.Multi (id INT NOT NULL PRIMARY KEY, tag NVARCHAR(10) NOT NULL)',
+      );
+      await harness.execute(
+        "INSERT INTO dbo.Multi VALUES (1, N'a'), (2, N'b'), (3, N'c')",
+      );
+      await harness.execute('''
+CREATE PROCEDURE dbo.MultiProc @min INT AS
+BEGIN
+  SET NOCOUNT ON;
+  SELECT id FROM dbo.Multi WHERE id >= @min ORDER BY id;
+  SELECT COUNT(*) AS n FROM dbo.Multi;
+END
+''');
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('returns every row-bearing set with its own rows', () async {
+      final sets = await harness.client.executeMulti('''
+SELECT id, tag FROM dbo.Multi ORDER BY id;
+UPDATE dbo.Multi SET tag = tag WHERE id = 1;
+SELECT COUNT(*) AS n FROM dbo.Multi;
+''');
+      expect(sets, hasLength(2));
+      expect(sets[0].columns, ['id', 'tag']);
+      expect(sets[0].rows.map((r) => r[0]).toList(), [1, 2, 3]);
+      expect(sets[0].affected, 3);
+      expect(sets[1].rowAt(0)['n'], 3);
+    });
+
+    test('stored procedure with parameters', () async {
+      final sets = await harness.client.executeMulti(
+        'EXEC dbo.MultiProc @min = @m',
+        params: {'m': 2},
+      );
+      expect(sets, hasLength(2));
+      expect(sets[0].rows.map((r) => r[0]).toList(), [2, 3]);
+      expect(sets[1].rows.single.single, 3);
+    });
+
+    test('unrequested sets are skipped', () async {
+      final sets = await harness.client.executeMulti(
+        'SELECT id FROM dbo.Multi; SELECT tag FROM dbo.Multi',
+        sets: {1},
+      );
+      expect(sets[0].columns, ['id']);
+      expect(sets[0].rows, isEmpty);
+      expect(sets[0].affected, 3);
+      expect(sets[1].rows, hasLength(3));
+    });
+
+    test('errors surface as SQLException', () async {
+      await expectLater(
+        harness.client.executeMulti('SELECT 1; SELECT * FROM dbo.Missing'),
+        throwsA(isA<SQLException>()),
+      );
+    });
+  });
+}
@@ -0,0 +1,241 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+MssqlPoolConfig _poolConfig(
+  String dbName, {
+  int minSize = 1,
+  int maxSize = 4,
+  int? packetSize,
+}) {
+  final server = Platform.environment['MSSQL_SERVER'] ?? '192.168.1.10:1433';
+  final parts = server.split(':');
+  return MssqlPoolConfig(
+    ip: parts.first,
+    port: parts.length > 1 ? parts[1] : '1433',
+    databaseName: dbName,
+    username: Platform.environment['MSSQL_USER'] ?? 'sa',
+    password:
+        Platform.environment['MSSQL_PASS'] ??
+        Platform.environment['MSSQL_PASSWORD'] ??
+        'eSeal@123',
+    minSize: minSize,
+    maxSize: maxSize,
+    packetSize: packetSize,
+  );
+}
+
+void main() {
+  group('MssqlPool', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('rejects inconsistent sizes', () async {
+      expect(
+        () => MssqlPool.open(_poolConfig(harness.dbName, minSize: 3, maxSize: 2)),
+        throwsA(isA<ArgumentError>()),
+      );
+    });
+
+    test('rejects an out-of-range packet size', () async {
+      expect(
+        () => MssqlPool.open(_poolConfig(harness.dbName, packetSize: 65536)),
+        throwsA(isA<ArgumentError>()),
+      );
+    });
+
+    test('sessions log in with the requested packet size', () async {
+      final pool = await MssqlPool.open(
+        _poolConfig(harness.dbName, packetSize: 16384),
+      );
+      try {
+        await pool.withConnection((c) async {
+          expect(c.packetSize, 16384);
+          final rows = parseRows(
+            await c.getData(
+              'SELECT net_packet_size AS size FROM sys.dm_exec_connections '
+              'WHERE session_id = @@SPID',
+            ),
+          );
+          expect(rows.single['size'], 16384);
+        });
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test('reuses sessions and reports metrics', () async {
+      final pool = await MssqlPool.open(_poolConfig(harness.dbName));
+      try {
+        expect(pool.metrics.idle, 1);
+        for (var i = 0; i < 5; i++) {
+          final rows = parseRows(await pool.getData('SELECT DB_NAME() AS db'));
+          expect(rows.first['db'], harness.dbName);
+        }
+        final m = pool.metrics;
+        expect(m.acquired, 5);
+        expect(m.inUse, 0);
+        expect(m.size, 1);
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test('acquire times out when the pool is exhausted', () async {
+      final pool = await MssqlPool.open(
+        _poolConfig(harness.dbName, minSize: 1, maxSize: 1),
+      );
+      try {
+        final held = await pool.acquire();
+        await expectLater(
+          pool.acquire(timeout: const Duration(milliseconds: 200)),
+          throwsA(isA<TimeoutException>()),
+        );
+        expect(pool.metrics.timeouts, 1);
+        final next = pool.acquire();
+        await held.release();
+        await (await next).release();
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test('release rolls back an open transaction', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.PoolTx (id INT NOT NULL PRIMARY KEY)',
+      );
+      final pool = await MssqlPool.open(
+        _poolConfig(harness.dbName, minSize: 1, maxSize: 1),
+      );
+      try {
+        final conn = await pool.acquire();
+        await conn.beginTransaction();
+        await conn.writeData('INSERT INTO dbo.PoolTx (id) VALUES (1)');
+        await conn.release();
+        expect(() => conn.getData('SELECT 1'), throwsA(isA<StateError>()));
+        final rows = parseRows(
+          await pool.getData('SELECT COUNT(*) AS n FROM dbo.PoolTx'),
+        );
+        expect(rows.first['n'], 0);
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test('release rolls back a transaction opened with raw SQL', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.PoolRawTx (id INT NOT NULL PRIMARY KEY)',
+      );
+      final pool = await MssqlPool.open(
+        _poolConfig(harness.dbName, minSize: 1, maxSize: 1),
+      );
+      try {
+        final conn = await pool.acquire();
+        await conn.writeData('BEGIN TRAN');
+        await conn.writeData('INSERT INTO dbo.PoolRawTx (id) VALUES (1)');
+        await conn.release();
+        final rows = parseRows(
+          await pool.getData(
+            'SELECT COUNT(*) AS n, @@TRANCOUNT AS tc FROM dbo.PoolRawTx',
+          ),
+        );
+        expect(rows.first['n'], 0);
+        expect(rows.first['tc'], 0);
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test('parallelBulkInsert shards rows across sessions', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.ParLoad (id INT NOT NULL, name NVARCHAR(50) NULL)',
+      );
+      final pool = await MssqlPool.open(_poolConfig(harness.dbName));
+      try {
+        final rows = List.generate(
+          10000,
+          (i) => <String, dynamic>{'id': i, 'name': 'r$i'},
+        );
+        expect(await pool.parallelBulkInsert('dbo.ParLoad', rows), 10000);
+        expect(
+          await pool.parallelBulkInsert(
+            'dbo.ParLoad',
+            rows,
+            connections: 3,
+            keyColumn: 'id',
+          ),
+          10000,
+        );
+        final out = parseRows(
+          await pool.getData(
+            'SELECT COUNT(*) AS n, COUNT(DISTINCT id) AS ids FROM dbo.ParLoad',
+          ),
+        );
+        expect(out.single['n'], 20000);
+        expect(out.single['ids'], 10000);
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test('parallelBulkInsert reports failed shards', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.ParLoad (id INT NOT NULL, name NVARCHAR(50) NULL)',
+      );
+      final pool = await MssqlPool.open(_poolConfig(harness.dbName));
+      try {
+        // Round-robin puts the NULL id (row 1) in the second of two shards.
+        final rows = List.generate(
+          100,
+          (i) => <String, dynamic>{'id': i == 1 ? null : i, 'name': 'r$i'},
+        );
+        await expectLater(
+          pool.parallelBulkInsert('dbo.ParLoad', rows, connections: 2),
+          throwsA(
+            isA<ParallelBulkInsertException>()
+                .having((e) => e.errors.keys, 'failed shards', [1])
+                .having((e) => e.shardCounts[0], 'first shard', 50),
+          ),
+        );
+      } finally {
+        await pool.close();
+      }
+    });
+
+    test(
+      'sessions run statements in parallel',
+      () async {
+        final pool = await MssqlPool.open(
+          _poolConfig(harness.dbName, minSize: 4, maxSize: 4),
+        );
+        try {
+          final sw = Stopwatch()..start();
+          await Future.wait(
+            List.generate(
+              4,
+              (_) => pool.getData("WAITFOR DELAY '00:00:01'; SELECT 1 AS x"),
+            ),
+          );
+          sw.stop();
+          expect(sw.elapsed, lessThan(const Duration(seconds: 3)));
+        } finally {
+          await pool.close();
+        }
+      },
+      skip: MssqlPool.runsInParallel
+          ? false
+          : 'mssql_native helper not available; sessions are serialized',
+    );
+  });
+}
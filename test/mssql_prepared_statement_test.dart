@@ -0,0 +1,116 @@
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('prepared statements', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+      await harness.recreateTable(
+        'CREATE TABLE dbo.PrepItems (id INT NOT NULL PRIMARY KEY, name NVARCHAR(50) NULL)',
+      );
+      await harness.execute(
+        "INSERT INTO dbo.PrepItems VALUES (1, N'one'), (2, N'two'), (3, N'trois')",
+      );
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('prepare once, execute many times', () async {
+      final stmt = await harness.client.prepare(
+        'SELECT name FROM dbo.PrepItems WHERE id = @id',
+        {'@id': 'int'},
+      );
+      for (final e in {1: 'one', 2: 'two', 3: 'trois'}.entries) {
+        final rs = await stmt.execute({'id': e.key});
+        expect(rs.rows.single.single, e.value);
+      }
+      await stmt.close();
+      await stmt.close(); // idempotent
+      expect(stmt.isClosed, isTrue);
+      await expectLater(stmt.execute({'id': 1}), throwsStateError);
+    });
+
+    test('writes through a prepared statement report affected rows', () async {
+      final stmt = await harness.client.prepare(
+        'UPDATE dbo.PrepItems SET name = @name WHERE id = @id',
+        {'@name': 'nvarchar(50)', '@id': 'int'},
+      );
+      final rs = await stmt.execute({'id': 3, 'name': 'three'});
+      expect(rs.affected, 1);
+      await stmt.close();
+
+      final rows = parseRows(
+        await harness.query('SELECT name FROM dbo.PrepItems WHERE id = 3'),
+      );
+      expect(rows.single['name'], 'three');
+    });
+
+    test('undeclared or missing parameters are rejected', () async {
+      final stmt = await harness.client.prepare(
+        'SELECT @a + @b AS s',
+        {'@a': 'int', '@b': 'int'},
+      );
+      await expectLater(stmt.execute({'a': 1}), throwsArgumentError);
+      await expectLater(
+        stmt.execute({'a': 1, 'b': 2, 'c': 3}),
+        throwsArgumentError,
+      );
+      expect((await stmt.execute({'a': 1, 'b': 2})).rows.single.single, 3);
+      await stmt.close();
+    });
+
+    test('repeated parameterized calls reuse the cached handle', () async {
+      for (var i = 0; i < 20; i++) {
+        final rows = parseRows(
+          await harness.executeParams(
+            'SELECT COUNT(*) AS n FROM dbo.PrepItems WHERE id <= @max',
+            {'max': i % 4},
+          ),
+        );
+        expect(rows.single['n'], i % 4);
+      }
+    });
+
+    test('statements are prepared again after a database switch', () async {
+      const sql = 'SELECT DB_NAME() AS db, @v AS v';
+      final before = await harness.client.getResultSetWithParams(sql, {'v': 1});
+      final db = before.rows.single[0] as String;
+
+      await harness.execute('USE [master]');
+      try {
+        final inMaster = await harness.client.getResultSetWithParams(sql, {
+          'v': 2,
+        });
+        expect(inMaster.rows.single, ['master', 2]);
+      } finally {
+        await harness.execute('USE [$db]');
+      }
+      final after = await harness.client.getResultSetWithParams(sql, {'v': 3});
+      expect(after.rows.single, [db, 3]);
+    });
+
+    test('a USE after a comment and without a space is recognized', () async {
+      const sql = 'SELECT DB_NAME() AS db, @v AS v';
+      final before = await harness.client.getResultSetWithParams(sql, {'v': 1});
+      final db = before.rows.single[0] as String;
+
+      await harness.execute(
+        "/* USE [$db] */ SELECT N'USE x' AS [USE y];USE[master]",
+      );
+      try {
+        final inMaster = await harness.client.getResultSetWithParams(sql, {
+          'v': 2,
+        });
+        expect(inMaster.rows.single, ['master', 2]);
+      } finally {
+        await harness.execute('USE [$db]');
+      }
+    });
+  });
+}
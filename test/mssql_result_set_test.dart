@@ -0,0 +1,61 @@
+import 'dart:convert';
+
+import 'package:mssql_connection/mssql_connection.dart';
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('ResultSet', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+      await harness.recreateTable(
+        'CREATE TABLE dbo.Rs (id INT NOT NULL PRIMARY KEY, name NVARCHAR(20) NULL, score FLOAT NULL)',
+      );
+      await harness.execute(
+        "INSERT INTO dbo.Rs VALUES (1, N'a', 1.5), (2, NULL, NULL), (3, N'c', 3.0)",
+      );
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    test('exposes typed values without JSON', () async {
+      final rs = await harness.client.getResultSet(
+        'SELECT id, name, score FROM dbo.Rs ORDER BY id',
+      );
+      expect(rs.columns, ['id', 'name', 'score']);
+      expect(rs.columnTypes, hasLength(3));
+      expect(rs.length, 3);
+      expect(rs.rows[0], [1, 'a', 1.5]);
+      expect(rs.rows[1], [2, null, null]);
+      expect(rs.rowAt(2), {'id': 3, 'name': 'c', 'score': 3.0});
+    });
+
+    test('toJsonString matches getData', () async {
+      const sql = 'SELECT id, name, score FROM dbo.Rs ORDER BY id';
+      final rs = await harness.client.getResultSet(sql);
+      final json = await harness.query(sql);
+      expect(jsonDecode(rs.toJsonString()), jsonDecode(json));
+      expect(identical(rs.toJsonString(), rs.toJsonString()), isTrue);
+      expect(jsonDecode(jsonEncode(rs)), parseJson(json));
+    });
+
+    test('parameters and affected counts', () async {
+      final rs = await harness.client.getResultSetWithParams(
+        'UPDATE dbo.Rs SET score = @s WHERE id >= @min',
+        {'s': 9.0, 'min': 2},
+      );
+      expect(rs.columns, isEmpty);
+      expect(rs.affected, 2);
+      final check = await harness.client.getResultSetWithParams(
+        'SELECT COUNT(*) AS n FROM dbo.Rs WHERE score = @s',
+        {'s': 9.0},
+      );
+      expect(check.rowAt(0)['n'], 2);
+    });
+  });
+}
@@ -0,0 +1,63 @@
+import 'package:test/test.dart';
+
+import 'test_utils.dart';
+
+void main() {
+  group('DDL session SET options', () {
+    final harness = TempDbHarness();
+
+    setUpAll(() async {
+      await harness.init();
+    });
+
+    tearDownAll(() async {
+      await harness.dispose();
+    });
+
+    Future<int> arithAbort() async {
+      final rows = parseRows(
+        await harness.query(
+          "SELECT CAST(SESSIONPROPERTY('ARITHABORT') AS INT) AS v",
+        ),
+      );
+      return rows.single['v'] as int;
+    }
+
+    test('indexed views can be created', () async {
+      await harness.recreateTable(
+        'CREATE TABLE dbo.OptItems (id INT NOT NULL, qty INT NOT NULL)',
+      );
+      await harness.execute(
+        'CREATE VIEW dbo.OptTotals WITH SCHEMABINDING AS '
+        'SELECT id, SUM(qty) AS total, COUNT_BIG(*) AS n '
+        'FROM dbo.OptItems GROUP BY id',
+      );
+      await harness.execute(
+        'CREATE UNIQUE CLUSTERED INDEX IX_OptTotals ON dbo.OptTotals (id)',
+      );
+      await harness.execute('DROP VIEW dbo.OptTotals');
+    });
+
+    test(
+      'options changed by a batch are restored before the next DDL',
+      () async {
+        await harness.execute('SET ARITHABORT OFF');
+        expect(await arithAbort(), 0);
+        await harness.recreateTable(
+          'CREATE TABLE dbo.OptReset (id INT NOT NULL)',
+        );
+        expect(await arithAbort(), 1);
+      },
+    );
+
+    test('DDL is recognized after comments and line breaks', () async {
+      await harness.execute('SET CONCAT_NULL_YIELDS_NULL, ARITHABORT OFF');
+      expect(await arithAbort(), 0);
+      await harness.execute(
+        '-- migration 42\n/* adds a table */\ncreate\ntable dbo.OptComment (id INT)',
+      );
+      expect(await arithAbort(), 1);
+      await harness.execute('DROP TABLE dbo.OptComment');
+    });
+  });
+}
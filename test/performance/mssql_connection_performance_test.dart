@@ -1,5 +1,6 @@
 import 'dart:io';
 import 'dart:math';
+import 'dart:typed_data';
 
 import 'package:mssql_connection/mssql_connection.dart';
 import 'package:test/test.dart';
@@ -71,6 +72,52 @@ void main() {
     });
   });
 
+  group('Performance: Session initialization round trips', () {
+    test('client packets and latency per connect()', () async {
+      final server =
+          Platform.environment['MSSQL_SERVER'] ?? '192.168.1.10:1433';
+      final parts = server.split(':');
+      const connects = 10;
+      final reads = <int>[];
+      final latencies = <int>[];
+      for (var i = 0; i < connects; i++) {
+        final conn = MssqlConnection.getInstance();
+        final sw = Stopwatch()..start();
+        final ok = await conn.connect(
+          ip: parts.first,
+          port: parts.length > 1 ? parts[1] : '1433',
+          databaseName: 'master',
+          username: Platform.environment['MSSQL_USER'] ?? 'sa',
+          password:
+              Platform.environment['MSSQL_PASS'] ??
+              Platform.environment['MSSQL_PASSWORD'] ??
+              'eSeal@123',
+          timeoutInSeconds: 15,
+        );
+        sw.stop();
+        expect(ok, isTrue, reason: 'Failed to connect');
+        // Packets the server has read from this session, including the
+        // login exchange, any initialization batches and this query.
+        final rows = parseRows(
+          await conn.getData(
+            'SELECT c.num_reads AS reads, DB_NAME() AS db '
+            'FROM sys.dm_exec_connections c WHERE c.session_id = @@SPID',
+          ),
+        );
+        expect(rows.single['db'], 'master');
+        reads.add((rows.single['reads'] as num).toInt());
+        latencies.add(sw.elapsedMilliseconds);
+        await conn.disconnect();
+      }
+      final avgMs = latencies.reduce((a, b) => a + b) / connects;
+      _printLine(
+        '[Connect] $connects connects: avg ${avgMs.toStringAsFixed(1)} ms, '
+        'client packets per session (login, SET TEXTSIZE, DMV query) '
+        'min=${reads.reduce(min)} max=${reads.reduce(max)}',
+      );
+    });
+  });
+
   group('Performance: Operations (DDL, DML, Params, Bulk, Query)', () {
     final db = TempDbHarness();
 
@@ -246,6 +293,62 @@ void main() {
       }, timeout: Timeout(Duration(days: 1)));
     }
 
+    for (final n in sizes) {
+      test(
+        'Bulk insert: $n rows, fully logged vs minimally logged (TABLOCK)',
+        () async {
+          // Minimal logging needs SIMPLE or BULK_LOGGED recovery and a heap
+          // (or empty clustered index) loaded under TABLOCK.
+          await db.execute('ALTER DATABASE CURRENT SET RECOVERY SIMPLE');
+          const chunk = 500000;
+          for (final options in const [
+            BulkOptions(),
+            BulkOptions(tableLock: true),
+          ]) {
+            final table =
+                'dbo.[PerfBulkLog_${DateTime.now().millisecondsSinceEpoch}]';
+            await db.recreateTable(
+              'CREATE TABLE $table (id INT NOT NULL, qty INT NOT NULL, price FLOAT NOT NULL)',
+            );
+            await db.execute('CHECKPOINT');
+            final logBefore = await _usedLogBytes(db);
+
+            var totalInserted = 0;
+            final sw = Stopwatch()..start();
+            for (var start = 0; start < n; start += chunk) {
+              final len = min(chunk, n - start);
+              final ids = Int32List(len);
+              final qty = Int32List(len);
+              final price = Float64List(len);
+              for (var i = 0; i < len; i++) {
+                ids[i] = start + i;
+                qty[i] = i % 100;
+                price[i] = i * 0.25;
+              }
+              totalInserted += await db.client.bulkInsertColumns(
+                table,
+                {'id': ids, 'qty': qty, 'price': price},
+                batchSize: 100000,
+                options: options,
+              );
+            }
+            sw.stop();
+            final logAfter = await _usedLogBytes(db);
+
+            expect(totalInserted, n);
+            _printBench(
+              op: options.tableLock ? 'Bulk Insert TABLOCK' : 'Bulk Insert logged',
+              rows: n,
+              ms: sw.elapsedMilliseconds,
+              extra:
+                  'log +${((logAfter - logBefore) / (1024 * 1024)).toStringAsFixed(1)} MB',
+            );
+          }
+        },
+        timeout: Timeout(Duration(days: 1)),
+      );
+    }
+
     for (final n in sizes) {
       test(
         'Query and retrieve $n rows (JSON encode included)',
@@ -298,6 +401,177 @@ SELECT i, REPLICATE(N'X', 20) FROM N OPTION (MAXRECURSION 0);
         timeout: Timeout(Duration(days: 1)),
       );
     }
+
+    for (final n in sizes) {
+      test(
+        'Packet size sweep: bulk insert and fetch of $n rows at 4K-32K',
+        () async {
+          final server =
+              Platform.environment['MSSQL_SERVER'] ?? '192.168.1.10:1433';
+          final parts = server.split(':');
+          final rows = List.generate(
+            n,
+            (i) => <String, dynamic>{
+              'id': i,
+              'qty': i * 3,
+              'note': 'packet_sweep_row_${i.toString().padLeft(12, '0')}',
+            },
+          );
+          // 32767 is the largest packet size TDS allows.
+          for (final packetSize in const [4096, 8192, 16384, 32767]) {
+            final table =
+                'dbo.[PerfPacket_${packetSize}_${DateTime.now().millisecondsSinceEpoch}]';
+            await db.recreateTable(
+              'CREATE TABLE $table (id INT NOT NULL, qty BIGINT NOT NULL, note NVARCHAR(100) NOT NULL)',
+            );
+            final pool = await MssqlPool.open(
+              MssqlPoolConfig(
+                ip: parts.first,
+                port: parts.length > 1 ? parts[1] : '1433',
+                databaseName: db.dbName,
+                username: Platform.environment['MSSQL_USER'] ?? 'sa',
+                password:
+                    Platform.environment['MSSQL_PASS'] ??
+                    Platform.environment['MSSQL_PASSWORD'] ??
+                    'eSeal@123',
+                minSize: 1,
+                maxSize: 1,
+                packetSize: packetSize,
+              ),
+            );
+            try {
+              await pool.withConnection((c) async {
+                final granted = c.packetSize;
+
+                final load = Stopwatch()..start();
+                final inserted = await c.bulkInsert(
+                  table,
+                  rows,
+                  batchSize: 10000,
+                );
+                load.stop();
+                expect(inserted, n);
+                _printBench(
+                  op: 'Packet $granted Bulk Insert',
+                  rows: n,
+                  ms: load.elapsedMilliseconds,
+                );
+
+                final fetch = Stopwatch()..start();
+                final res = await c.queryColumnar(
+                  'SELECT id, qty, note FROM $table',
+                );
+                fetch.stop();
+                expect(res.rowCount, n);
+                _printBench(
+                  op: 'Packet $granted Fetch',
+                  rows: n,
+                  ms: fetch.elapsedMilliseconds,
+                );
+              });
+            } finally {
+              await pool.close();
+              await db.execute('DROP TABLE $table');
+            }
+          }
+        },
+        timeout: Timeout(Duration(days: 1)),
+      );
+    }
+
+    for (final n in sizes) {
+      test(
+        'Columnar query $n numeric rows (queryColumnar)',
+        () async {
+          final table =
+              'dbo.[PerfColumnar_${DateTime.now().millisecondsSinceEpoch}]';
+          await db.recreateTable(
+            'CREATE TABLE $table (id INT NOT NULL PRIMARY KEY, qty BIGINT NOT NULL, price FLOAT NULL)',
+          );
+          await db.execute('''
+DECLARE @N BIGINT = $n;
+;WITH N AS (
+  SELECT 1 AS i
+  UNION ALL
+  SELECT i + 1 FROM N WHERE i < @N
+)
+INSERT INTO $table (id, qty, price)
+SELECT i, i * 3, CASE WHEN i % 100 = 0 THEN NULL ELSE i * 0.5 END FROM N
+OPTION (MAXRECURSION 0);
+''');
+
+          final rssBefore = _rssMB();
+          final sw = Stopwatch()..start();
+          final res = await db.client.queryColumnar(
+            'SELECT id, qty, price FROM $table ORDER BY id',
+          );
+          sw.stop();
+          expect(res.rowCount, n);
+          var sum = 0.0;
+          final prices = res.column('price')!.float64Values;
+          for (var i = 0; i < prices.length; i++) {
+            sum += prices[i];
+          }
+          expect(sum, greaterThan(0));
+          final rssAfter = _rssMB();
+
+          _printBench(
+            op: 'Columnar',
+            rows: n,
+            ms: sw.elapsedMilliseconds,
+            extra: 'RSS +${(rssAfter - rssBefore).toStringAsFixed(1)} MB',
+          );
+        },
+        timeout: Timeout(Duration(days: 1)),
+      );
+    }
+
+    for (final n in sizes) {
+      test(
+        'Stream $n rows (getDataStream, bounded memory)',
+        () async {
+          final table =
+              'dbo.[PerfStream_${DateTime.now().millisecondsSinceEpoch}]';
+          await db.recreateTable(
+            'CREATE TABLE $table (id INT NOT NULL PRIMARY KEY, payload NVARCHAR(50) NOT NULL)',
+          );
+          await db.execute('''
+DECLARE @N BIGINT = $n;
+;WITH N AS (
+  SELECT 1 AS i
+  UNION ALL
+  SELECT i + 1 FROM N WHERE i < @N
+)
+INSERT INTO $table (id, payload)
+SELECT i, REPLICATE(N'X', 20) FROM N OPTION (MAXRECURSION 0);
+''');
+
+          final rssBefore = _rssMB();
+          var rssPeak = rssBefore;
+          var seen = 0;
+          final sw = Stopwatch()..start();
+          await for (final batch in db.client.getDataStream(
+            'SELECT id, payload FROM $table ORDER BY id',
+            batchSize: 5000,
+          )) {
+            seen += batch.length;
+            final rss = _rssMB();
+            if (rss > rssPeak) rssPeak = rss;
+          }
+          sw.stop();
+          expect(seen, n);
+
+          _printBench(
+            op: 'Stream',
+            rows: n,
+            ms: sw.elapsedMilliseconds,
+            extra:
+                'RSS peak +${(rssPeak - rssBefore).toStringAsFixed(1)} MB',
+          );
+        },
+        timeout: Timeout(Duration(days: 1)),
+      );
+    }
   });
 }
 
@@ -366,6 +640,15 @@ double _rssMB() {
   }
 }
 
+Future<int> _usedLogBytes(TempDbHarness db) async {
+  final rows = parseRows(
+    await db.query(
+      'SELECT used_log_space_in_bytes AS used FROM sys.dm_db_log_space_usage',
+    ),
+  );
+  return (rows.single['used'] as num).toInt();
+}
+
 // Lightweight reserve extension to reduce re-allocations for large bulk lists.
 extension on List<Map<String, dynamic>> {
   // Capacity hint; Dart lists don't expose capacity so this is a no-op.